@@ -0,0 +1,6 @@
+# AllocationCounter - replacement of global operator new/delete that counts allocations
+# shared by projects of the workshop - include after add_executable()
+target_sources(${PROJECT_NAME} PRIVATE
+  ${CMAKE_CURRENT_LIST_DIR}/allocation_counter.cpp
+  ${CMAKE_CURRENT_LIST_DIR}/allocation_counter.hpp)
+target_include_directories(${PROJECT_NAME} PRIVATE ${CMAKE_CURRENT_LIST_DIR})
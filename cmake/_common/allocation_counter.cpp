@@ -0,0 +1,125 @@
+#include "allocation_counter.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace
+{
+    std::atomic<size_t> allocation_count {0};
+    std::atomic<size_t> allocated_bytes {0};
+
+    void* counted_allocate(size_t size)
+    {
+        allocation_count.fetch_add(1, std::memory_order_relaxed);
+        allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+
+        if (void* ptr = std::malloc(size == 0 ? 1 : size))
+            return ptr;
+
+        throw std::bad_alloc {};
+    }
+
+    void* counted_allocate(size_t size, std::align_val_t alignment)
+    {
+        allocation_count.fetch_add(1, std::memory_order_relaxed);
+        allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+
+        const size_t align = static_cast<size_t>(alignment);
+        const size_t rounded_size = (size + align - 1) / align * align;
+
+#ifdef _WIN32
+        // no std::aligned_alloc in MSVC - memory has to be released by _aligned_free()
+        if (void* ptr = _aligned_malloc(rounded_size == 0 ? align : rounded_size, align))
+            return ptr;
+#else
+        if (void* ptr = std::aligned_alloc(align, rounded_size == 0 ? align : rounded_size))
+            return ptr;
+#endif
+
+        throw std::bad_alloc {};
+    }
+
+    void aligned_free(void* ptr) noexcept
+    {
+#ifdef _WIN32
+        _aligned_free(ptr);
+#else
+        std::free(ptr);
+#endif
+    }
+}
+
+size_t AllocationCounter::allocations() noexcept
+{
+    return allocation_count.load(std::memory_order_relaxed);
+}
+
+size_t AllocationCounter::allocated_bytes() noexcept
+{
+    return ::allocated_bytes.load(std::memory_order_relaxed);
+}
+
+// replacements of global allocation functions - all other forms delegate to these
+void* operator new(size_t size)
+{
+    return counted_allocate(size);
+}
+
+void* operator new[](size_t size)
+{
+    return counted_allocate(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    return counted_allocate(size, alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+    return counted_allocate(size, alignment);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+    aligned_free(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept
+{
+    aligned_free(ptr);
+}
+
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept
+{
+    aligned_free(ptr);
+}
+
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept
+{
+    aligned_free(ptr);
+}
@@ -0,0 +1,39 @@
+#ifndef ALLOCATION_COUNTER_HPP
+#define ALLOCATION_COUNTER_HPP
+
+#include <cstddef>
+
+namespace AllocationCounter
+{
+    // number of calls to global operator new/new[] since the start of the program
+    size_t allocations() noexcept;
+
+    // bytes requested from global operator new/new[] since the start of the program
+    size_t allocated_bytes() noexcept;
+
+    // counts global allocations made during the lifetime of the scope
+    class Scope
+    {
+        size_t start_;
+        size_t start_bytes_;
+
+    public:
+        Scope() noexcept
+            : start_ {allocations()}
+            , start_bytes_ {allocated_bytes()}
+        {
+        }
+
+        size_t count() const noexcept
+        {
+            return allocations() - start_;
+        }
+
+        size_t bytes() const noexcept
+        {
+            return allocated_bytes() - start_bytes_;
+        }
+    };
+}
+
+#endif // ALLOCATION_COUNTER_HPP
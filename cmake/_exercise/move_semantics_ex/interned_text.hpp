@@ -0,0 +1,217 @@
+#ifndef INTERNED_TEXT_HPP_
+#define INTERNED_TEXT_HPP_
+
+#include "legacy_paragraph.hpp"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+////////////////////////////////////////////////////////////////////////////
+// InternTable - identical texts share one immutable, reference counted buffer
+//
+// intern() returns InternedText - a handle of pointer size. Copy of a handle increments the counter,
+// entry is removed from the table with its last handle. Text of an entry is kept in a Paragraph - short
+// text inline in the entry (one allocation), long text in a block of SizeClassPool. Text ends at
+// the first '\0'.
+// Table is thread-safe and has to outlive all handles it created.
+
+class InternTable;
+
+class InternedText
+{
+    friend class InternTable;
+
+    struct Entry
+    {
+        std::atomic<size_t> refs;
+        InternTable* table;
+        LegacyCode::Paragraph paragraph;
+
+        Entry(InternTable* t, std::string_view text) : refs{1}, table{t}, paragraph{text.data(), text.size()}
+        {
+        }
+
+        std::string_view view() const noexcept
+        {
+            return std::string_view{paragraph.get_paragraph(), paragraph.length()};
+        }
+    };
+
+    Entry* entry_ = nullptr;
+
+    explicit InternedText(Entry* entry) noexcept : entry_{entry}
+    {
+    }
+
+    void release() noexcept;
+
+public:
+    InternedText() = default;
+
+    InternedText(const InternedText& other) noexcept : entry_{other.entry_}
+    {
+        if (entry_)
+            entry_->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    InternedText& operator=(const InternedText& other) noexcept
+    {
+        InternedText temp(other);
+        swap(temp);
+
+        return *this;
+    }
+
+    InternedText(InternedText&& other) noexcept : entry_{std::exchange(other.entry_, nullptr)}
+    {
+    }
+
+    InternedText& operator=(InternedText&& other) noexcept
+    {
+        InternedText temp(std::move(other));
+        swap(temp);
+
+        return *this;
+    }
+
+    ~InternedText()
+    {
+        release();
+    }
+
+    void swap(InternedText& other) noexcept
+    {
+        std::swap(entry_, other.entry_);
+    }
+
+    // no allocation - view is valid as long as any handle of the text exists
+    std::string_view view() const noexcept
+    {
+        return entry_ ? entry_->view() : std::string_view{};
+    }
+
+    // null-terminated
+    const char* c_str() const noexcept
+    {
+        return entry_ ? entry_->paragraph.get_paragraph() : "";
+    }
+
+    // storage of the text - nullptr for empty handle
+    const LegacyCode::Paragraph* paragraph() const noexcept
+    {
+        return entry_ ? &entry_->paragraph : nullptr;
+    }
+
+    size_t use_count() const noexcept
+    {
+        return entry_ ? entry_->refs.load(std::memory_order_relaxed) : 0;
+    }
+
+    // interned texts are equal if they share a buffer
+    friend bool operator==(const InternedText& a, const InternedText& b) noexcept
+    {
+        return a.entry_ == b.entry_;
+    }
+
+    friend bool operator!=(const InternedText& a, const InternedText& b) noexcept
+    {
+        return a.entry_ != b.entry_;
+    }
+};
+
+class InternTable
+{
+    friend class InternedText;
+    using Entry = InternedText::Entry;
+
+    mutable std::mutex mtx_;
+    std::unordered_map<std::string_view, Entry*> entries_; // keys view chars stored in entries
+    size_t text_bytes_ = 0;
+
+    // counter can drop to zero only under the lock - intern() cannot resurrect an entry being removed
+    void release(Entry* entry) noexcept
+    {
+        size_t refs = entry->refs.load(std::memory_order_relaxed);
+        while (refs > 1)
+        {
+            if (entry->refs.compare_exchange_weak(refs, refs - 1, std::memory_order_release, std::memory_order_relaxed))
+                return;
+        }
+
+        std::lock_guard<std::mutex> lk{mtx_};
+
+        if (entry->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            auto pos = entries_.find(entry->view());
+            if (pos != entries_.end() && pos->second == entry)
+                entries_.erase(pos);
+            text_bytes_ -= entry->paragraph.length();
+
+            delete entry;
+        }
+    }
+
+public:
+    // pool is created first - it outlives the table & paragraphs of its entries
+    InternTable()
+    {
+        SizeClassPool::instance();
+    }
+
+    InternTable(const InternTable&) = delete;
+    InternTable& operator=(const InternTable&) = delete;
+
+    static InternTable& global()
+    {
+        static InternTable table;
+        return table;
+    }
+
+    InternedText intern(std::string_view text)
+    {
+        // Paragraph keeps text up to the first '\0' - key has to be the same
+        text = text.substr(0, text.find('\0'));
+
+        std::lock_guard<std::mutex> lk{mtx_};
+
+        auto pos = entries_.find(text);
+        if (pos != entries_.end())
+        {
+            pos->second->refs.fetch_add(1, std::memory_order_relaxed);
+            return InternedText{pos->second};
+        }
+
+        // key views the text stored in the entry
+        auto entry = std::make_unique<Entry>(this, text);
+        entries_.emplace(entry->view(), entry.get());
+        text_bytes_ += entry->paragraph.length();
+
+        return InternedText{entry.release()};
+    }
+
+    // number of distinct texts
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> lk{mtx_};
+        return entries_.size();
+    }
+
+    // bytes of distinct texts (without terminators & counters)
+    size_t text_bytes() const
+    {
+        std::lock_guard<std::mutex> lk{mtx_};
+        return text_bytes_;
+    }
+};
+
+inline void InternedText::release() noexcept
+{
+    if (entry_)
+        entry_->table->release(entry_);
+}
+
+#endif /*INTERNED_TEXT_HPP_*/
@@ -0,0 +1,214 @@
+#ifndef LEGACY_PARAGRAPH_HPP_
+#define LEGACY_PARAGRAPH_HPP_
+
+#include "render_batch.hpp"
+#include "size_class_pool.hpp"
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+namespace LegacyCode
+{
+    // Paragraph stores text of any length:
+    // - text shorter than inline_capacity is stored in the object itself (no allocation)
+    // - longer text is stored in a block from SizeClassPool
+    // Moved-from paragraph has no text - get_paragraph() returns nullptr.
+    class Paragraph
+    {
+    public:
+        static constexpr size_t inline_capacity = 64; // including terminating '\0'
+
+    private:
+        char* buffer_;
+        size_t length_;
+        size_t capacity_;
+        char inline_buffer_[inline_capacity];
+
+        bool is_inline() const noexcept
+        {
+            return capacity_ <= inline_capacity;
+        }
+
+        void release() noexcept
+        {
+            if (!is_inline())
+                SizeClassPool::instance().deallocate(buffer_, capacity_);
+        }
+
+        // txt may point into own buffer
+        void assign(const char* txt, size_t length)
+        {
+            if (buffer_ != nullptr && length < capacity_)
+                std::memmove(buffer_, txt, length);
+            else
+            {
+                const size_t capacity = (length < inline_capacity) ? inline_capacity : SizeClassPool::block_size(length + 1);
+                char* buffer = (capacity == inline_capacity) ? inline_buffer_ : static_cast<char*>(SizeClassPool::instance().allocate(capacity));
+
+                std::memcpy(buffer, txt, length);
+                release();
+                buffer_ = buffer;
+                capacity_ = capacity;
+            }
+
+            buffer_[length] = '\0';
+            length_ = length;
+        }
+
+        static void check_not_null(const char* txt)
+        {
+            if (txt == nullptr)
+                throw std::invalid_argument("Text cannot be null");
+        }
+
+    protected:
+        void swap(Paragraph& p) noexcept
+        {
+            const bool this_inline = buffer_ == inline_buffer_;
+            const bool other_inline = p.buffer_ == p.inline_buffer_;
+
+            char temp[inline_capacity];
+            if (this_inline)
+                std::memcpy(temp, inline_buffer_, length_ + 1);
+            if (other_inline)
+                std::memcpy(inline_buffer_, p.inline_buffer_, p.length_ + 1);
+            if (this_inline)
+                std::memcpy(p.inline_buffer_, temp, length_ + 1);
+
+            std::swap(buffer_, p.buffer_);
+            std::swap(length_, p.length_);
+            std::swap(capacity_, p.capacity_);
+
+            // pointers to inline buffers must follow the swapped text
+            if (other_inline)
+                buffer_ = inline_buffer_;
+            if (this_inline)
+                p.buffer_ = p.inline_buffer_;
+        }
+
+    public:
+        Paragraph() : Paragraph("Default text!")
+        {
+        }
+
+        Paragraph(const Paragraph& p) : buffer_{nullptr}, length_{0}, capacity_{inline_capacity}
+        {
+            if (p.buffer_)
+                assign(p.buffer_, p.length_);
+        }
+
+        Paragraph(const char* txt) : buffer_{nullptr}, length_{0}, capacity_{inline_capacity}
+        {
+            set_paragraph(txt);
+        }
+
+        // copies at most max_length characters - txt does not have to be null-terminated
+        Paragraph(const char* txt, size_t max_length) : buffer_{nullptr}, length_{0}, capacity_{inline_capacity}
+        {
+            set_paragraph(txt, max_length);
+        }
+
+        Paragraph& operator=(const Paragraph& p)
+        {
+            if (this != &p)
+            {
+                if (p.buffer_)
+                    assign(p.buffer_, p.length_);
+                else
+                {
+                    Paragraph temp(p); // copy of paragraph without text
+                    swap(temp);
+                }
+            }
+
+            return *this;
+        }
+
+        Paragraph(Paragraph&& p) noexcept : buffer_{p.buffer_}, length_{p.length_}, capacity_{p.capacity_}
+        {
+            if (p.buffer_ == p.inline_buffer_)
+            {
+                std::memcpy(inline_buffer_, p.inline_buffer_, length_ + 1);
+                buffer_ = inline_buffer_;
+            }
+
+            p.buffer_ = nullptr;
+            p.length_ = 0;
+            p.capacity_ = inline_capacity;
+        }
+
+        Paragraph& operator=(Paragraph&& p) noexcept
+        {
+            Paragraph temp(std::move(p));
+            swap(temp);
+
+            return *this;
+        }
+
+        // storage grows to fit the text - no overflow
+        void set_paragraph(const char* txt)
+        {
+            check_not_null(txt);
+            assign(txt, std::strlen(txt));
+        }
+
+        // copies at most max_length characters
+        void set_paragraph(const char* txt, size_t max_length)
+        {
+            check_not_null(txt);
+
+            size_t length = 0;
+            while (length < max_length && txt[length] != '\0')
+                ++length;
+
+            assign(txt, length);
+        }
+
+        const char* get_paragraph() const
+        {
+            return buffer_;
+        }
+
+        size_t length() const noexcept
+        {
+            return length_;
+        }
+
+        // bytes reserved for text - inline_capacity if text is stored in the object
+        size_t capacity() const noexcept
+        {
+            return capacity_;
+        }
+
+        void render_at(int posx, int posy) const
+        {
+            render_at(std::cout, posx, posy);
+        }
+
+        void render_at(std::ostream& out, int posx, int posy) const
+        {
+            out << "Rendering text '" << buffer_ << "' at: [" << posx << ", " << posy << "]" << std::endl;
+        }
+
+        // same output as render_at(posx, posy) - written to batch, no flush
+        void render_at(RenderBatch& batch, int posx, int posy) const
+        {
+            batch.append("Rendering text '", 16)
+                .append(buffer_ ? buffer_ : "", length_)
+                .append("' at: [", 7)
+                .append(posx)
+                .append(", ", 2)
+                .append(posy)
+                .append("]\n", 2);
+        }
+
+        ~Paragraph()
+        {
+            release();
+        }
+    };
+}
+
+#endif /*LEGACY_PARAGRAPH_HPP_*/
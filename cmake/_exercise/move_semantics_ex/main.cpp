@@ -1,9 +1,19 @@
 #define CATCH_CONFIG_MAIN
 
 #include "catch.hpp"
+#include <chrono>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
 #include "paragraph.hpp"
 
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
 using namespace std;
 
 TEST_CASE("Moving paragraph")
@@ -33,4 +43,265 @@ TEST_CASE("swap for Text")
 
     REQUIRE(t1.text() == "BBB"s);
     REQUIRE(t2.text() == "AAA"s);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Paragraph - short text is stored inline")
+{
+    LegacyCode::Paragraph p("short text");
+
+    REQUIRE(p.get_paragraph() == "short text"s);
+    REQUIRE(p.length() == 10);
+    REQUIRE(p.capacity() == LegacyCode::Paragraph::inline_capacity);
+
+    LegacyCode::Paragraph copy = p;
+    REQUIRE(copy.get_paragraph() == "short text"s);
+    REQUIRE(copy.get_paragraph() != p.get_paragraph());
+}
+
+TEST_CASE("Paragraph - long text is stored in pooled block")
+{
+    const string long_text(100, 'x');
+
+    LegacyCode::Paragraph p(long_text.c_str());
+
+    REQUIRE(p.get_paragraph() == long_text);
+    REQUIRE(p.capacity() == 128);
+
+    SECTION("copy")
+    {
+        LegacyCode::Paragraph copy = p;
+
+        REQUIRE(copy.get_paragraph() == long_text);
+        REQUIRE(copy.get_paragraph() != p.get_paragraph());
+    }
+
+    SECTION("move steals block")
+    {
+        const char* buffer = p.get_paragraph();
+        LegacyCode::Paragraph target = move(p);
+
+        REQUIRE(target.get_paragraph() == buffer);
+        REQUIRE(p.get_paragraph() == nullptr);
+    }
+
+    SECTION("text longer than the largest size class")
+    {
+        const string huge_text(10000, 'y');
+
+        p.set_paragraph(huge_text.c_str());
+
+        REQUIRE(p.get_paragraph() == huge_text);
+        REQUIRE(p.capacity() == 10001);
+    }
+}
+
+TEST_CASE("Paragraph - set_paragraph")
+{
+    LegacyCode::Paragraph p("abc");
+
+    SECTION("text longer than 1024 chars does not overflow")
+    {
+        const string long_text(5000, 'z');
+
+        p.set_paragraph(long_text.c_str());
+
+        REQUIRE(p.get_paragraph() == long_text);
+        REQUIRE(p.length() == 5000);
+    }
+
+    SECTION("shorter text reuses storage")
+    {
+        p.set_paragraph(string(200, 'a').c_str());
+        const char* buffer = p.get_paragraph();
+
+        p.set_paragraph("b");
+
+        REQUIRE(p.get_paragraph() == buffer);
+        REQUIRE(p.get_paragraph() == "b"s);
+    }
+
+    SECTION("at most max_length characters are copied")
+    {
+        const char not_terminated[] = {'x', 'y', 'z'};
+
+        p.set_paragraph(not_terminated, 3);
+        REQUIRE(p.get_paragraph() == "xyz"s);
+
+        p.set_paragraph("text", 100);
+        REQUIRE(p.get_paragraph() == "text"s);
+    }
+
+    SECTION("own text")
+    {
+        p.set_paragraph(string(100, 'c').c_str());
+        p.set_paragraph(p.get_paragraph() + 1);
+
+        REQUIRE(p.get_paragraph() == string(99, 'c'));
+    }
+
+    SECTION("null is rejected")
+    {
+        REQUIRE_THROWS_AS(p.set_paragraph(nullptr), const std::invalid_argument&);
+        REQUIRE(p.get_paragraph() == "abc"s);
+    }
+
+    SECTION("moved-from paragraph can get new text")
+    {
+        LegacyCode::Paragraph target = move(p);
+
+        p.set_paragraph("new");
+        REQUIRE(p.get_paragraph() == "new"s);
+    }
+}
+
+TEST_CASE("Paragraph - assignments")
+{
+    LegacyCode::Paragraph short_p("short");
+    LegacyCode::Paragraph long_p(string(300, 'l').c_str());
+
+    SECTION("copy")
+    {
+        short_p = long_p;
+        REQUIRE(short_p.get_paragraph() == string(300, 'l'));
+
+        long_p = LegacyCode::Paragraph("x");
+        long_p = short_p;
+        REQUIRE(long_p.get_paragraph() == string(300, 'l'));
+    }
+
+    SECTION("copy of moved-from paragraph")
+    {
+        LegacyCode::Paragraph target = move(long_p);
+
+        short_p = long_p;
+        REQUIRE(short_p.get_paragraph() == nullptr);
+    }
+
+    SECTION("move - inline & pooled")
+    {
+        std::swap(short_p, long_p);
+
+        REQUIRE(short_p.get_paragraph() == string(300, 'l'));
+        REQUIRE(long_p.get_paragraph() == "short"s);
+    }
+}
+
+TEST_CASE("SizeClassPool")
+{
+    SECTION("requests are rounded up to size classes")
+    {
+        REQUIRE(SizeClassPool::block_size(1) == 128);
+        REQUIRE(SizeClassPool::block_size(129) == 256);
+        REQUIRE(SizeClassPool::block_size(4096) == 4096);
+        REQUIRE(SizeClassPool::block_size(4097) == 4097);
+    }
+
+    SECTION("freed blocks are reused")
+    {
+        SizeClassPool pool;
+
+        void* block = pool.allocate(256);
+        pool.deallocate(block, 256);
+
+        REQUIRE(pool.allocate(256) == block);
+    }
+}
+
+namespace
+{
+    // resident set size of the process in bytes - 0 if unknown
+    size_t resident_memory()
+    {
+#ifdef __linux__
+        std::ifstream statm{"/proc/self/statm"};
+        size_t total_pages = 0, resident_pages = 0;
+        statm >> total_pages >> resident_pages;
+
+        return resident_pages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#else
+        return 0;
+#endif
+    }
+
+    // previous implementation of Paragraph - every paragraph allocates 1024 bytes
+    class FixedBufferText : public Shape
+    {
+        int x_, y_;
+        std::unique_ptr<char[]> buffer_;
+
+    public:
+        FixedBufferText(int x, int y, const std::string& text) : x_{x}, y_{y}, buffer_{new char[1024]}
+        {
+            std::strcpy(buffer_.get(), text.c_str());
+        }
+
+        void draw(std::ostream& out) const override
+        {
+            out << "Rendering text '" << buffer_.get() << "' at: [" << x_ << ", " << y_ << "]" << std::endl;
+        }
+
+        void draw(RenderBatch& batch) const override
+        {
+            batch.append("Rendering text '").append(buffer_.get()).append("' at: [").append(x_).append(", ").append(y_).append("]\n");
+        }
+    };
+
+    // text shape with its own copy of text in Paragraph
+    class ParagraphText : public Shape
+    {
+        int x_, y_;
+        LegacyCode::Paragraph p_;
+
+    public:
+        ParagraphText(int x, int y, const std::string& text) : x_{x}, y_{y}, p_{text.c_str(), text.size()}
+        {
+        }
+
+        void draw(std::ostream& out) const override
+        {
+            p_.render_at(out, x_, y_);
+        }
+
+        void draw(RenderBatch& batch) const override
+        {
+            p_.render_at(batch, x_, y_);
+        }
+    };
+
+    template <typename TText>
+    void benchmark_text_shapes(const std::string& description, const std::vector<std::string>& texts)
+    {
+        std::vector<TText> shapes;
+        shapes.reserve(texts.size());
+
+        const size_t rss_before = resident_memory();
+        const auto start = std::chrono::steady_clock::now();
+
+        for (size_t i = 0; i < texts.size(); ++i)
+            shapes.emplace_back(static_cast<int>(i), 0, texts[i]);
+
+        const auto end = std::chrono::steady_clock::now();
+        const size_t rss_after = resident_memory();
+
+        const double seconds = std::chrono::duration<double>(end - start).count();
+
+        std::cout << description << ": "
+                  << static_cast<size_t>(texts.size() / seconds) << " shapes/s, RSS growth = "
+                  << (rss_after - rss_before) / (1024 * 1024) << " MB\n";
+    }
+}
+
+TEST_CASE("Text shapes - 10^6 objects", "[.][benchmark]")
+{
+    const size_t no_of_shapes = 1'000'000;
+
+    // most paragraphs are shorter than 64 chars, every 10th is longer
+    std::vector<std::string> texts;
+    texts.reserve(no_of_shapes);
+    for (size_t i = 0; i < no_of_shapes; ++i)
+        texts.push_back(std::string(i % 10 == 0 ? 200 + i % 300 : 10 + i % 50, 'a' + i % 26));
+
+    benchmark_text_shapes<ParagraphText>("Paragraph - inline & pooled storage", texts);
+    benchmark_text_shapes<FixedBufferText>("Paragraph - fixed 1024 byte buffer", texts);
+    benchmark_text_shapes<Text>("Text - interned", texts);
+}
@@ -1,111 +1,181 @@
 #ifndef PARAGRAPH_HPP_
 #define PARAGRAPH_HPP_
 
+#include "interned_text.hpp"
+#include "legacy_paragraph.hpp"
+#include "render_batch.hpp"
+#include "rope.hpp"
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <variant>
 
-namespace LegacyCode
+class Shape
 {
-    class Paragraph
+public:
+    virtual ~Shape() = default;
+    virtual void draw(std::ostream& out) const = 0;
+
+    void draw() const
     {
-        char* buffer_;
+        draw(std::cout);
+    }
 
-    protected:
-        void swap(Paragraph& p) noexcept
-        {
-            std::swap(buffer_, p.buffer_);
-        }
+    // default for shapes that do not support batching - draw(std::ostream&) writes to the batch
+    virtual void draw(RenderBatch& batch) const
+    {
+        RenderBatchStream out{batch};
+        draw(out);
+    }
+};
 
-    public:
-        Paragraph() : buffer_(new char[1024])
-        {
-            std::strcpy(buffer_, "Default text!");
-        }
+// Text keeps its content interned - shapes with the same text share one Paragraph (inline or pooled storage).
+// First in-place edit (insert_text/erase_text) turns the content into a private Rope.
+class Text : public Shape
+{
+    int x_, y_;
+    std::variant<InternedText, std::unique_ptr<Rope>> content_; // rope on the heap - Text stays small
 
-        Paragraph(const Paragraph& p) : buffer_(new char[1024])
-        {
-            std::strcpy(buffer_, p.buffer_);
-        }
+    Rope& editable_content()
+    {
+        if (auto* interned = std::get_if<InternedText>(&content_))
+            content_ = std::make_unique<Rope>(interned->view());
 
-        Paragraph(const char* txt) : buffer_(new char[1024])
-        {
-            std::strcpy(buffer_, txt);
-        }
+        return *std::get<std::unique_ptr<Rope>>(content_);
+    }
 
-        Paragraph& operator=(const Paragraph& p) 
-        {
-            Paragraph temp(p);
-            swap(temp);
+    // interned text is stored & rendered by a Paragraph of the intern table - nullptr for edited text
+    const LegacyCode::Paragraph* paragraph() const noexcept
+    {
+        const auto* interned = std::get_if<InternedText>(&content_);
+        return interned ? interned->paragraph() : nullptr;
+    }
 
-            return *this;
-        }
+public:
+    using Shape::draw;
 
-        Paragraph(Paragraph&& p) noexcept : buffer_{p.buffer_}
-        {
-            p.buffer_ = nullptr;
-        }
+    Text(int x, int y, const std::string& text) : Text{x, y, InternTable::global().intern(text)}
+    {}
 
-        Paragraph& operator=(Paragraph&& p) noexcept
-        {
-            Paragraph temp(std::move(p));
-            swap(temp);
-            
-            return *this;
-        }
+    Text(int x, int y, InternedText text) : x_{x}, y_{y}, content_{std::move(text)}
+    {}
 
-        void set_paragraph(const char* txt)
-        {
-            std::strcpy(buffer_, txt);
-        }
+    Text(const Text& other) : Shape(other), x_{other.x_}, y_{other.y_}, content_{InternedText{}}
+    {
+        if (const auto* rope = std::get_if<std::unique_ptr<Rope>>(&other.content_))
+            content_ = std::make_unique<Rope>(**rope);
+        else
+            content_ = std::get<InternedText>(other.content_);
+    }
 
-        const char* get_paragraph() const
-        {
-            return buffer_;
-        }
+    Text& operator=(const Text& other)
+    {
+        Text temp(other);
+        *this = std::move(temp);
 
-        void render_at(int posx, int posy) const
-        {
-            std::cout << "Rendering text '" << buffer_ << "' at: [" << posx << ", " << posy << "]" << std::endl;
-        }
+        return *this;
+    }
 
-        ~Paragraph()
+    Text(Text&&) = default;
+    Text& operator=(Text&&) = default;
+
+    void draw(std::ostream& out) const override
+    {
+        if (const auto* p = paragraph())
+            p->render_at(out, x_, y_);
+        else
+            out << "Rendering text '" << text_view() << "' at: [" << x_ << ", " << y_ << "]" << std::endl;
+    }
+
+    void draw(RenderBatch& batch) const override
+    {
+        if (const auto* p = paragraph())
         {
-            delete[] buffer_;
+            p->render_at(batch, x_, y_);
+            return;
         }
-    };
-}
 
-class Shape
-{
-public:
-    virtual ~Shape() = default;
-    virtual void draw() const = 0;    
-};
+        batch.append("Rendering text '", 16);
 
-class Text : public Shape
-{
-    int x_, y_;
-    LegacyCode::Paragraph p_;
-public:
-    Text(int x, int y, const std::string& text) : x_{x}, y_{y}, p_{text.c_str()}
-    {}
+        if (const auto* rope = std::get_if<std::unique_ptr<Rope>>(&content_))
+            (*rope)->for_each_chunk([&batch](std::string_view chunk) { batch.append(chunk.data(), chunk.size()); });
 
-    void draw() const override
-    {
-        p_.render_at(x_, y_);
+        batch.append("' at: [", 7).append(x_).append(", ", 2).append(y_).append("]\n", 2);
     }
 
     std::string text() const
     {
-        const char* txt = p_.get_paragraph(); 
-        return (txt == nullptr) ? "" : txt;
+        return std::string{text_view()};
+    }
+
+    // does not allocate for interned text - edited text is flattened once after each edit
+    // view is valid until the text is changed
+    std::string_view text_view() const
+    {
+        if (const auto* rope = std::get_if<std::unique_ptr<Rope>>(&content_))
+            return (*rope)->view();
+
+        return std::get<InternedText>(content_).view();
+    }
+
+    // content is shared with other shapes with the same text
+    bool is_interned() const noexcept
+    {
+        return std::holds_alternative<InternedText>(content_);
     }
 
     void set_text(const std::string& text)
     {
-        p_.set_paragraph(text.c_str());
+        content_ = InternTable::global().intern(text);
+    }
+
+    // throws std::out_of_range if pos is larger than length of text
+    void insert_text(size_t pos, std::string_view text)
+    {
+        editable_content().insert(pos, text);
+    }
+
+    void erase_text(size_t pos, size_t count)
+    {
+        editable_content().erase(pos, count);
     }
 };
 
+namespace Details
+{
+    template <typename TShape>
+    const Shape& as_shape(const TShape& shape, std::true_type)
+    {
+        return shape;
+    }
+
+    template <typename TPtr>
+    const Shape& as_shape(const TPtr& ptr, std::false_type)
+    {
+        return *ptr;
+    }
+
+    template <typename T>
+    const Shape& as_shape(const T& shape_or_ptr)
+    {
+        return as_shape(shape_or_ptr, std::is_base_of<Shape, T>{});
+    }
+}
+
+// draws shapes (objects or pointers) into the batch and writes the frame to the sink at once
+template <typename TShapes>
+void render_frame(const TShapes& shapes, RenderBatch& batch)
+{
+    for (const auto& shape : shapes)
+        Details::as_shape(shape).draw(batch);
+
+    batch.flush();
+}
+
 #endif /*PARAGRAPH_HPP_*/
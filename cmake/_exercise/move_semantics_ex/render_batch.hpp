@@ -0,0 +1,232 @@
+#ifndef RENDER_BATCH_HPP_
+#define RENDER_BATCH_HPP_
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <system_error>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////
+// RenderBatch - draw commands of a frame collected in a buffer
+//
+// Shapes append their output to the batch, flush() writes the whole frame to a sink
+// with one call. Buffer keeps its capacity between frames - no allocations in steady state.
+// Frames larger than flush_threshold are written in parts.
+
+class RenderSink
+{
+public:
+    virtual ~RenderSink() = default;
+    virtual void write(const char* data, size_t size) = 0;
+};
+
+class StreamSink : public RenderSink
+{
+    std::ostream& out_;
+
+public:
+    explicit StreamSink(std::ostream& out) : out_{out}
+    {
+    }
+
+    void write(const char* data, size_t size) override
+    {
+        out_.write(data, static_cast<std::streamsize>(size));
+        out_.flush();
+    }
+};
+
+// writes to file descriptor - does not own it
+class FdSink : public RenderSink
+{
+    int fd_;
+
+public:
+    explicit FdSink(int fd) : fd_{fd}
+    {
+    }
+
+    // throws std::system_error if write fails
+    void write(const char* data, size_t size) override
+    {
+        while (size > 0)
+        {
+#ifdef _WIN32
+            const int written = ::_write(fd_, data, static_cast<unsigned int>(size));
+#else
+            const ssize_t written = ::write(fd_, data, size);
+#endif
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+
+                throw std::system_error(errno, std::generic_category(), "write to render sink failed");
+            }
+
+            data += written;
+            size -= static_cast<size_t>(written);
+        }
+    }
+};
+
+// collects output in memory - used in tests
+class MemorySink : public RenderSink
+{
+    std::string content_;
+    size_t no_of_writes_ = 0;
+
+public:
+    void write(const char* data, size_t size) override
+    {
+        content_.append(data, size);
+        ++no_of_writes_;
+    }
+
+    const std::string& content() const
+    {
+        return content_;
+    }
+
+    size_t no_of_writes() const
+    {
+        return no_of_writes_;
+    }
+};
+
+class RenderBatch
+{
+    RenderSink& sink_;
+    std::string buffer_;
+    size_t flush_threshold_;
+
+    void flush_if_full()
+    {
+        if (buffer_.size() >= flush_threshold_)
+            flush();
+    }
+
+public:
+    static constexpr size_t default_flush_threshold = 1024 * 1024;
+
+    explicit RenderBatch(RenderSink& sink, size_t flush_threshold = default_flush_threshold)
+        : sink_{sink}, flush_threshold_{flush_threshold}
+    {
+        buffer_.reserve(flush_threshold);
+    }
+
+    RenderBatch(const RenderBatch&) = delete;
+    RenderBatch& operator=(const RenderBatch&) = delete;
+
+    // pending output is flushed - errors of the sink are ignored
+    ~RenderBatch()
+    {
+        try
+        {
+            flush();
+        }
+        catch (...)
+        {
+        }
+    }
+
+    RenderBatch& append(const char* text, size_t length)
+    {
+        buffer_.append(text, length);
+        flush_if_full();
+
+        return *this;
+    }
+
+    RenderBatch& append(const char* text)
+    {
+        return append(text, std::strlen(text));
+    }
+
+    RenderBatch& append(int value)
+    {
+        char digits[16];
+        char* end = digits + sizeof(digits);
+        char* begin = end;
+
+        unsigned int magnitude = value < 0 ? 0u - static_cast<unsigned int>(value) : static_cast<unsigned int>(value);
+        do
+        {
+            *--begin = static_cast<char>('0' + magnitude % 10);
+            magnitude /= 10;
+        } while (magnitude != 0);
+
+        if (value < 0)
+            *--begin = '-';
+
+        return append(begin, static_cast<size_t>(end - begin));
+    }
+
+    // writes pending output to the sink
+    void flush()
+    {
+        if (buffer_.empty())
+            return;
+
+        sink_.write(buffer_.data(), buffer_.size());
+        buffer_.clear();
+    }
+
+    size_t pending() const noexcept
+    {
+        return buffer_.size();
+    }
+};
+
+// std::ostream that appends to a batch - output of shapes that write to streams
+// errors of the sink are rethrown by the stream
+class RenderBatchStream : public std::ostream
+{
+    class Buffer : public std::streambuf
+    {
+        RenderBatch& batch_;
+
+    public:
+        explicit Buffer(RenderBatch& batch) : batch_{batch}
+        {
+        }
+
+    protected:
+        int_type overflow(int_type ch) override
+        {
+            if (!traits_type::eq_int_type(ch, traits_type::eof()))
+            {
+                const char c = traits_type::to_char_type(ch);
+                batch_.append(&c, 1);
+            }
+
+            return traits_type::not_eof(ch);
+        }
+
+        std::streamsize xsputn(const char* text, std::streamsize length) override
+        {
+            batch_.append(text, static_cast<size_t>(length));
+            return length;
+        }
+    };
+
+    Buffer buffer_;
+
+public:
+    explicit RenderBatchStream(RenderBatch& batch) : std::ostream{nullptr}, buffer_{batch}
+    {
+        rdbuf(&buffer_);
+        exceptions(std::ios_base::badbit);
+    }
+};
+
+#endif /*RENDER_BATCH_HPP_*/
@@ -0,0 +1,210 @@
+#include "catch.hpp"
+#include "paragraph.hpp"
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#endif
+
+using namespace std;
+
+TEST_CASE("RenderBatch - output of Text is the same as output of draw()")
+{
+    Text txt{10, -20, "text"};
+
+    stringstream expected;
+    txt.draw(expected);
+
+    MemorySink sink;
+    {
+        RenderBatch batch{sink};
+        txt.draw(batch);
+    }
+
+    REQUIRE(sink.content() == expected.str());
+}
+
+namespace
+{
+    // shape without support for batching
+    class Circle : public Shape
+    {
+        int r_;
+
+    public:
+        explicit Circle(int r) : r_{r}
+        {
+        }
+
+        void draw(std::ostream& out) const override
+        {
+            out << "Drawing circle r: " << r_ << std::endl;
+        }
+    };
+}
+
+TEST_CASE("RenderBatch - shapes without batching are rendered by draw(std::ostream&)")
+{
+    vector<unique_ptr<Shape>> scene;
+    scene.push_back(make_unique<Circle>(5));
+    scene.push_back(make_unique<Text>(1, 2, "text"));
+
+    stringstream cout_output;
+    auto* cout_buffer = cout.rdbuf(cout_output.rdbuf());
+
+    MemorySink sink;
+    RenderBatch batch{sink};
+    render_frame(scene, batch);
+
+    cout.rdbuf(cout_buffer);
+
+    REQUIRE(sink.content() == "Drawing circle r: 5\nRendering text 'text' at: [1, 2]\n");
+    REQUIRE(sink.no_of_writes() == 1);
+    REQUIRE(cout_output.str().empty());
+}
+
+TEST_CASE("RenderBatch - one write per frame")
+{
+    vector<unique_ptr<Shape>> scene;
+    for (int i = 0; i < 100; ++i)
+        scene.push_back(make_unique<Text>(i, i, "shape"));
+
+    MemorySink sink;
+    RenderBatch batch{sink};
+
+    render_frame(scene, batch);
+    REQUIRE(sink.no_of_writes() == 1);
+    REQUIRE(batch.pending() == 0);
+
+    render_frame(scene, batch);
+    REQUIRE(sink.no_of_writes() == 2);
+    REQUIRE(sink.content().find("Rendering text 'shape' at: [99, 99]\n") != string::npos);
+}
+
+TEST_CASE("RenderBatch - frame larger than threshold is written in parts")
+{
+    vector<Text> scene(10, Text{1, 2, "0123456789"});
+
+    MemorySink sink;
+    RenderBatch batch{sink, 64};
+
+    render_frame(scene, batch);
+
+    REQUIRE(sink.no_of_writes() > 1);
+    REQUIRE(sink.content().size() == 10 * string("Rendering text '0123456789' at: [1, 2]\n").size());
+}
+
+TEST_CASE("RenderBatch - formatting of ints")
+{
+    MemorySink sink;
+
+    {
+        RenderBatch batch{sink};
+        batch.append(0).append(" ").append(-7).append(" ").append(INT_MAX).append(" ").append(INT_MIN);
+    }
+
+    REQUIRE(sink.content() == to_string(0) + " -7 " + to_string(INT_MAX) + " " + to_string(INT_MIN));
+}
+
+TEST_CASE("RenderBatch - moved-from Text renders empty text")
+{
+    Text txt{1, 2, "text"};
+    Text target = move(txt);
+
+    MemorySink sink;
+    RenderBatch batch{sink};
+    txt.draw(batch);
+    batch.flush();
+
+    REQUIRE(sink.content() == "Rendering text '' at: [1, 2]\n");
+}
+
+TEST_CASE("RenderBatch - stream sink")
+{
+    ostringstream out;
+    StreamSink sink{out};
+    RenderBatch batch{sink};
+
+    batch.append("frame");
+    REQUIRE(out.str().empty());
+
+    batch.flush();
+    REQUIRE(out.str() == "frame");
+}
+
+#ifndef _WIN32
+TEST_CASE("RenderBatch - fd sink")
+{
+    FILE* file = tmpfile();
+    REQUIRE(file != nullptr);
+
+    {
+        FdSink sink{fileno(file)};
+        RenderBatch batch{sink};
+        batch.append("frame ").append(1);
+    }
+
+    rewind(file);
+    char content[16] = {};
+    REQUIRE(fread(content, 1, sizeof(content) - 1, file) == 7);
+    REQUIRE(content == string("frame 1"));
+
+    fclose(file);
+}
+
+namespace
+{
+    template <typename TFunction>
+    double measure_seconds(TFunction f)
+    {
+        const auto start = chrono::steady_clock::now();
+        f();
+        const auto end = chrono::steady_clock::now();
+
+        return chrono::duration<double>(end - start).count();
+    }
+}
+
+TEST_CASE("Render 10^5 shapes", "[.][benchmark]")
+{
+    const int no_of_shapes = 100'000;
+
+    vector<unique_ptr<Shape>> scene;
+    for (int i = 0; i < no_of_shapes; ++i)
+        scene.push_back(make_unique<Text>(i, -i, "text of shape number " + to_string(i)));
+
+    const auto report = [no_of_shapes](const string& description, double seconds) {
+        cout << description << ": " << static_cast<size_t>(no_of_shapes / seconds) << " shapes/s\n";
+    };
+
+    ofstream null_stream{"/dev/null"};
+    const double per_shape = measure_seconds([&] {
+        for (const auto& shape : scene)
+            shape->draw(null_stream);
+    });
+    report("draw() - std::endl per shape", per_shape);
+
+    StreamSink stream_sink{null_stream};
+    RenderBatch stream_batch{stream_sink};
+    report("RenderBatch - stream sink", measure_seconds([&] { render_frame(scene, stream_batch); }));
+
+    const int fd = open("/dev/null", O_WRONLY);
+    {
+        FdSink fd_sink{fd};
+        RenderBatch fd_batch{fd_sink};
+        report("RenderBatch - fd sink", measure_seconds([&] { render_frame(scene, fd_batch); }));
+    }
+    close(fd);
+
+    MemorySink memory_sink;
+    RenderBatch memory_batch{memory_sink};
+    report("RenderBatch - memory sink", measure_seconds([&] { render_frame(scene, memory_batch); }));
+}
+#endif
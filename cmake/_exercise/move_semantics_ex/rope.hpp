@@ -0,0 +1,180 @@
+#ifndef ROPE_HPP_
+#define ROPE_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////
+// Rope - text stored as a sequence of chunks of at most max_chunk_size chars
+//
+// Insert & erase touch only chunks at the edited position - the rest of a long paragraph
+// is not moved. view() flattens the text into a cached buffer, valid until the next edit.
+
+class Rope
+{
+public:
+    static constexpr size_t max_chunk_size = 1024;
+
+private:
+    std::vector<std::string> chunks_;
+    size_t size_ = 0;
+    mutable std::string flat_;
+    mutable bool flat_valid_ = true;
+
+    // index of chunk containing pos & offset in this chunk - pos == size() gives end of the last chunk
+    std::pair<size_t, size_t> locate(size_t pos) const
+    {
+        if (pos > size_)
+            throw std::out_of_range("Rope position out of range");
+
+        size_t index = 0;
+        while (index + 1 < chunks_.size() && pos > chunks_[index].size())
+        {
+            pos -= chunks_[index].size();
+            ++index;
+        }
+
+        return {index, pos};
+    }
+
+    // splits oversized chunk into chunks of half of max size - room for next inserts
+    void split(size_t index)
+    {
+        if (chunks_[index].size() <= max_chunk_size)
+            return;
+
+        std::string chunk = std::move(chunks_[index]);
+        std::vector<std::string> parts;
+        for (size_t offset = 0; offset < chunk.size(); offset += max_chunk_size / 2)
+            parts.push_back(chunk.substr(offset, max_chunk_size / 2));
+
+        chunks_.erase(chunks_.begin() + index);
+        chunks_.insert(chunks_.begin() + index, std::make_move_iterator(parts.begin()), std::make_move_iterator(parts.end()));
+    }
+
+public:
+    Rope() = default;
+
+    explicit Rope(std::string_view text)
+    {
+        insert(0, text);
+    }
+
+    Rope(const Rope&) = default;
+    Rope& operator=(const Rope&) = default;
+
+    Rope(Rope&& other) noexcept
+        : chunks_{std::move(other.chunks_)}
+        , size_{std::exchange(other.size_, 0)}
+        , flat_{std::move(other.flat_)}
+        , flat_valid_{std::exchange(other.flat_valid_, true)}
+    {
+        other.chunks_.clear();
+        other.flat_.clear();
+    }
+
+    Rope& operator=(Rope&& other) noexcept
+    {
+        Rope temp(std::move(other));
+        std::swap(chunks_, temp.chunks_);
+        std::swap(size_, temp.size_);
+        std::swap(flat_, temp.flat_);
+        std::swap(flat_valid_, temp.flat_valid_);
+
+        return *this;
+    }
+
+    size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    size_t no_of_chunks() const noexcept
+    {
+        return chunks_.size();
+    }
+
+    // throws std::out_of_range if pos > size()
+    void insert(size_t pos, std::string_view text)
+    {
+        if (text.empty())
+            return;
+
+        if (chunks_.empty())
+            chunks_.emplace_back();
+
+        auto [index, offset] = locate(pos);
+        chunks_[index].insert(offset, text.data(), text.size());
+        size_ += text.size();
+        flat_valid_ = false;
+
+        split(index);
+    }
+
+    void append(std::string_view text)
+    {
+        insert(size_, text);
+    }
+
+    // erases at most count chars - throws std::out_of_range if pos > size()
+    void erase(size_t pos, size_t count)
+    {
+        auto [index, offset] = locate(pos);
+        count = std::min(count, size_ - pos);
+        size_ -= count;
+        flat_valid_ = flat_valid_ && count == 0;
+
+        while (count > 0)
+        {
+            std::string& chunk = chunks_[index];
+            const size_t erased = std::min(count, chunk.size() - offset);
+
+            chunk.erase(offset, erased);
+            count -= erased;
+
+            if (chunk.empty())
+                chunks_.erase(chunks_.begin() + index);
+            else
+            {
+                ++index;
+                offset = 0;
+            }
+        }
+    }
+
+    // f is called with string_view of every chunk
+    template <typename TFunction>
+    void for_each_chunk(TFunction f) const
+    {
+        for (const auto& chunk : chunks_)
+            f(std::string_view{chunk});
+    }
+
+    std::string to_string() const
+    {
+        return std::string{view()};
+    }
+
+    // allocates only first time after edit
+    std::string_view view() const
+    {
+        if (!flat_valid_)
+        {
+            flat_.clear();
+            flat_.reserve(size_);
+            for (const auto& chunk : chunks_)
+                flat_ += chunk;
+
+            flat_valid_ = true;
+        }
+
+        return flat_;
+    }
+};
+
+#endif /*ROPE_HPP_*/
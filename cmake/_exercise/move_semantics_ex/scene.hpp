@@ -0,0 +1,175 @@
+#ifndef SCENE_HPP_
+#define SCENE_HPP_
+
+#include "paragraph.hpp"
+#include <cstddef>
+#include <initializer_list>
+#include <iostream>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////
+// Scene - shapes stored by value in a contiguous array per type
+//
+// Shapes of types listed in TShapes are drawn without virtual calls (qualified call of draw()
+// of the concrete type). Other subclasses of Shape are kept in a fallback bucket
+// of pointers and drawn virtually.
+//
+// Drawing order: bucket by bucket (in order of TShapes, fallback bucket is the last),
+// shapes of the same type in order of insertion.
+// References returned by emplace() are invalidated by next insertion of the same type.
+
+namespace Details
+{
+    template <typename T, typename... Ts>
+    struct Contains : std::false_type
+    {
+    };
+
+    template <typename T, typename TFirst, typename... TRest>
+    struct Contains<T, TFirst, TRest...>
+        : std::conditional_t<std::is_same<T, TFirst>::value, std::true_type, Contains<T, TRest...>>
+    {
+    };
+
+    template <bool... Bs>
+    struct All : std::is_same<std::integer_sequence<bool, true, Bs...>, std::integer_sequence<bool, Bs..., true>>
+    {
+    };
+
+    // qualified call - no virtual dispatch
+    template <typename TShape>
+    void draw_static(const TShape& shape)
+    {
+        shape.TShape::draw(std::cout);
+    }
+
+    template <typename TShape>
+    void draw_static(const TShape& shape, RenderBatch& batch)
+    {
+        shape.TShape::draw(batch);
+    }
+
+    // shapes from fallback bucket
+    inline void draw_static(const Shape& shape)
+    {
+        shape.draw();
+    }
+
+    inline void draw_static(const Shape& shape, RenderBatch& batch)
+    {
+        shape.draw(batch);
+    }
+}
+
+template <typename... TShapes>
+class Scene
+{
+    static_assert(Details::All<std::is_base_of<Shape, TShapes>::value...>::value, "Scene can store only subclasses of Shape");
+
+    std::tuple<std::vector<TShapes>...> buckets_;
+    std::vector<std::unique_ptr<Shape>> others_;
+
+    template <typename TShape, typename... TArgs>
+    TShape& emplace_shape(std::true_type, TArgs&&... args)
+    {
+        auto& bucket = std::get<std::vector<TShape>>(buckets_);
+        bucket.emplace_back(std::forward<TArgs>(args)...);
+
+        return bucket.back();
+    }
+
+    template <typename TShape, typename... TArgs>
+    TShape& emplace_shape(std::false_type, TArgs&&... args)
+    {
+        auto shape = std::make_unique<TShape>(std::forward<TArgs>(args)...);
+        TShape& result = *shape;
+        others_.push_back(std::move(shape));
+
+        return result;
+    }
+
+    template <typename TFunction, size_t... Is>
+    void for_each_bucket(TFunction& f, std::index_sequence<Is...>) const
+    {
+        (void)std::initializer_list<int>{(f(std::get<Is>(buckets_)), 0)...};
+    }
+
+public:
+    template <typename TShape>
+    static constexpr bool is_stored_by_value = Details::Contains<TShape, TShapes...>::value;
+
+    template <typename TShape, typename... TArgs>
+    TShape& emplace(TArgs&&... args)
+    {
+        static_assert(std::is_base_of<Shape, TShape>::value, "TShape must be a subclass of Shape");
+
+        return emplace_shape<TShape>(Details::Contains<TShape, TShapes...>{}, std::forward<TArgs>(args)...);
+    }
+
+    // shape of any type - dynamic type is not inspected, so it always lands in the fallback bucket
+    void add(std::unique_ptr<Shape> shape)
+    {
+        others_.push_back(std::move(shape));
+    }
+
+    template <typename TShape>
+    void reserve(size_t capacity)
+    {
+        std::get<std::vector<TShape>>(buckets_).reserve(capacity);
+    }
+
+    // f is called with reference to concrete type for shapes stored by value, with const Shape& for others
+    template <typename TFunction>
+    void for_each(TFunction f) const
+    {
+        auto visit_bucket = [&f](const auto& bucket) {
+            for (const auto& shape : bucket)
+                f(shape);
+        };
+
+        for_each_bucket(visit_bucket, std::index_sequence_for<TShapes...>{});
+
+        for (const auto& shape : others_)
+            f(static_cast<const Shape&>(*shape));
+    }
+
+    void draw() const
+    {
+        for_each([](const auto& shape) { Details::draw_static(shape); });
+    }
+
+    void draw(RenderBatch& batch) const
+    {
+        for_each([&batch](const auto& shape) { Details::draw_static(shape, batch); });
+    }
+
+    size_t size() const noexcept
+    {
+        size_t result = others_.size();
+
+        auto count = [&result](const auto& bucket) { result += bucket.size(); };
+        for_each_bucket(count, std::index_sequence_for<TShapes...>{});
+
+        return result;
+    }
+
+    void clear() noexcept
+    {
+        auto clear_bucket = [](auto& bucket) { bucket.clear(); };
+        (void)std::initializer_list<int>{(clear_bucket(std::get<std::vector<TShapes>>(buckets_)), 0)...};
+        others_.clear();
+    }
+};
+
+template <typename... TShapes>
+void render_frame(const Scene<TShapes...>& scene, RenderBatch& batch)
+{
+    scene.draw(batch);
+    batch.flush();
+}
+
+#endif /*SCENE_HPP_*/
@@ -0,0 +1,200 @@
+#include "catch.hpp"
+#include "scene.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace
+{
+    class Rectangle : public Shape
+    {
+        int width_, height_;
+
+    public:
+        Rectangle(int width, int height) : width_{width}, height_{height}
+        {
+        }
+
+        void draw(std::ostream& out) const override
+        {
+            out << "Drawing rectangle " << width_ << "x" << height_ << endl;
+        }
+
+        void draw(RenderBatch& batch) const override
+        {
+            batch.append("Drawing rectangle ").append(width_).append("x").append(height_).append("\n");
+        }
+    };
+
+    // user-defined shape not known to scene
+    class Circle : public Shape
+    {
+        int radius_;
+
+    public:
+        explicit Circle(int radius) : radius_{radius}
+        {
+        }
+
+        void draw(std::ostream& out) const override
+        {
+            out << "Drawing circle " << radius_ << endl;
+        }
+
+        void draw(RenderBatch& batch) const override
+        {
+            batch.append("Drawing circle ").append(radius_).append("\n");
+        }
+    };
+}
+
+TEST_CASE("Scene - shapes of listed types are stored by value")
+{
+    Scene<Text, Rectangle> scene;
+
+    static_assert(Scene<Text, Rectangle>::is_stored_by_value<Text>, "Text is stored by value");
+    static_assert(!Scene<Text, Rectangle>::is_stored_by_value<Circle>, "Circle is stored in fallback bucket");
+
+    scene.reserve<Text>(2);
+    Text& first = scene.emplace<Text>(1, 2, "first");
+    Text& second = scene.emplace<Text>(3, 4, "second");
+
+    REQUIRE(&second == &first + 1);
+    REQUIRE(scene.size() == 2);
+}
+
+TEST_CASE("Scene - drawing order")
+{
+    Scene<Text, Rectangle> scene;
+
+    scene.emplace<Circle>(5);
+    scene.emplace<Text>(1, 2, "first");
+    scene.emplace<Rectangle>(10, 20);
+    scene.add(make_unique<Text>(0, 0, "pointer"));
+    scene.emplace<Text>(3, 4, "second");
+
+    REQUIRE(scene.size() == 5);
+
+    MemorySink sink;
+    RenderBatch batch{sink};
+    render_frame(scene, batch);
+
+    REQUIRE(sink.no_of_writes() == 1);
+    REQUIRE(sink.content() ==
+        "Rendering text 'first' at: [1, 2]\n"
+        "Rendering text 'second' at: [3, 4]\n"
+        "Drawing rectangle 10x20\n"
+        "Drawing circle 5\n"
+        "Rendering text 'pointer' at: [0, 0]\n");
+}
+
+TEST_CASE("Scene - for_each gets concrete types")
+{
+    Scene<Text> scene;
+    scene.emplace<Text>(1, 2, "text");
+    scene.emplace<Circle>(1);
+
+    struct Visitor
+    {
+        int texts = 0;
+        int others = 0;
+
+        void operator()(const Text&) { ++texts; }
+        void operator()(const Shape&) { ++others; }
+    };
+
+    Visitor visitor;
+    scene.for_each([&visitor](const auto& shape) { visitor(shape); });
+
+    REQUIRE(visitor.texts == 1);
+    REQUIRE(visitor.others == 1);
+}
+
+TEST_CASE("Scene - clear")
+{
+    Scene<Text> scene;
+    scene.emplace<Text>(1, 2, "text");
+    scene.emplace<Circle>(1);
+
+    scene.clear();
+
+    REQUIRE(scene.size() == 0);
+}
+
+namespace
+{
+    class NullSink : public RenderSink
+    {
+    public:
+        void write(const char*, size_t) override
+        {
+        }
+    };
+
+    template <typename TScene>
+    double seconds_per_frame(const TScene& scene, RenderSink& sink)
+    {
+        RenderBatch batch{sink};
+        render_frame(scene, batch); // warm up
+
+        const int no_of_frames = 5;
+        const auto start = chrono::steady_clock::now();
+
+        for (int i = 0; i < no_of_frames; ++i)
+            render_frame(scene, batch);
+
+        const auto end = chrono::steady_clock::now();
+
+        return chrono::duration<double>(end - start).count() / no_of_frames;
+    }
+}
+
+TEST_CASE("Scene vs vector<unique_ptr<Shape>> - drawing", "[.][benchmark]")
+{
+    NullSink sink;
+
+    for (size_t no_of_shapes : {1'000u, 10'000u, 100'000u, 1'000'000u, 10'000'000u})
+    {
+        const auto report = [no_of_shapes](const string& description, double seconds) {
+            cout << description << " - " << no_of_shapes << " shapes: "
+                 << static_cast<size_t>(no_of_shapes / seconds) << " shapes/s\n";
+        };
+
+        {
+            Scene<Text, Rectangle> scene;
+            scene.reserve<Text>(no_of_shapes / 2);
+            scene.reserve<Rectangle>(no_of_shapes / 2);
+
+            for (size_t i = 0; i < no_of_shapes; ++i)
+                if (i % 2 == 0)
+                    scene.emplace<Text>(static_cast<int>(i), 0, "text");
+                else
+                    scene.emplace<Rectangle>(static_cast<int>(i), 1);
+
+            report("Scene<Text, Rectangle>", seconds_per_frame(scene, sink));
+        }
+
+        {
+            vector<unique_ptr<Shape>> scene;
+            scene.reserve(no_of_shapes);
+
+            for (size_t i = 0; i < no_of_shapes; ++i)
+                if (i % 2 == 0)
+                    scene.push_back(make_unique<Text>(static_cast<int>(i), 0, "text"));
+                else
+                    scene.push_back(make_unique<Rectangle>(static_cast<int>(i), 1));
+
+            report("vector<unique_ptr<Shape>> - allocation order", seconds_per_frame(scene, sink));
+
+            // shapes added & removed over time are scattered on the heap
+            shuffle(scene.begin(), scene.end(), mt19937{42});
+            report("vector<unique_ptr<Shape>> - shuffled", seconds_per_frame(scene, sink));
+        }
+    }
+}
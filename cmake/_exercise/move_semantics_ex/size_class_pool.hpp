@@ -0,0 +1,129 @@
+#ifndef SIZE_CLASS_POOL_HPP_
+#define SIZE_CLASS_POOL_HPP_
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////
+// SizeClassPool - pool of blocks of 128, 256, ..., 4096 bytes
+//
+// Requests are rounded up to the nearest size class, blocks are carved from 64 KB slabs
+// and recycled through a free list of the class. Larger requests go to operator new.
+// Slabs are returned to the system when the pool is destroyed (at the end of the program).
+
+class SizeClassPool
+{
+public:
+    static constexpr size_t min_block_size = 128;
+    static constexpr size_t max_block_size = 4096;
+    static constexpr size_t slab_size = 64 * 1024;
+
+private:
+    static constexpr size_t no_of_classes = 6; // 128 << 5 == 4096
+
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    struct SizeClass
+    {
+        std::mutex mtx;
+        FreeBlock* free_list = nullptr;
+        std::vector<void*> slabs;
+    };
+
+    SizeClass classes_[no_of_classes];
+
+    static size_t class_index(size_t block_size) noexcept
+    {
+        size_t index = 0;
+        for (size_t size = min_block_size; size < block_size; size *= 2)
+            ++index;
+
+        return index;
+    }
+
+    // carves a new slab into free blocks - called with locked mutex of size class
+    static void refill(SizeClass& size_class, size_t block_size)
+    {
+        char* slab = static_cast<char*>(::operator new(slab_size));
+        size_class.slabs.push_back(slab);
+
+        for (size_t offset = 0; offset < slab_size; offset += block_size)
+        {
+            FreeBlock* block = reinterpret_cast<FreeBlock*>(slab + offset);
+            block->next = size_class.free_list;
+            size_class.free_list = block;
+        }
+    }
+
+public:
+    SizeClassPool() = default;
+    SizeClassPool(const SizeClassPool&) = delete;
+    SizeClassPool& operator=(const SizeClassPool&) = delete;
+
+    ~SizeClassPool()
+    {
+        for (SizeClass& size_class : classes_)
+            for (void* slab : size_class.slabs)
+                ::operator delete(slab);
+    }
+
+    static SizeClassPool& instance()
+    {
+        static SizeClassPool pool;
+        return pool;
+    }
+
+    // size of block that is really allocated for size bytes
+    static size_t block_size(size_t size) noexcept
+    {
+        if (size > max_block_size)
+            return size;
+
+        size_t block_size = min_block_size;
+        while (block_size < size)
+            block_size *= 2;
+
+        return block_size;
+    }
+
+    // block_size must be a value returned by block_size()
+    void* allocate(size_t block_size)
+    {
+        if (block_size > max_block_size)
+            return ::operator new(block_size);
+
+        SizeClass& size_class = classes_[class_index(block_size)];
+        std::lock_guard<std::mutex> lk{size_class.mtx};
+
+        if (!size_class.free_list)
+            refill(size_class, block_size);
+
+        FreeBlock* block = size_class.free_list;
+        size_class.free_list = block->next;
+
+        return block;
+    }
+
+    void deallocate(void* ptr, size_t block_size) noexcept
+    {
+        if (block_size > max_block_size)
+        {
+            ::operator delete(ptr);
+            return;
+        }
+
+        SizeClass& size_class = classes_[class_index(block_size)];
+        std::lock_guard<std::mutex> lk{size_class.mtx};
+
+        FreeBlock* block = static_cast<FreeBlock*>(ptr);
+        block->next = size_class.free_list;
+        size_class.free_list = block;
+    }
+};
+
+#endif /*SIZE_CLASS_POOL_HPP_*/
@@ -0,0 +1,280 @@
+#include "allocation_counter.hpp"
+#include "catch.hpp"
+#include "paragraph.hpp"
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+TEST_CASE("InternTable - identical texts share buffer")
+{
+    InternTable table;
+
+    InternedText t1 = table.intern("label");
+    InternedText t2 = table.intern(string("label"));
+    InternedText t3 = table.intern("other label");
+
+    REQUIRE(t1 == t2);
+    REQUIRE(t1.view().data() == t2.view().data());
+    REQUIRE(t1 != t3);
+    REQUIRE(table.size() == 2);
+    REQUIRE(t1.use_count() == 2);
+    REQUIRE(t1.c_str() == "label"s);
+}
+
+TEST_CASE("InternTable - text is removed with its last handle")
+{
+    InternTable table;
+
+    {
+        InternedText t1 = table.intern("label");
+        InternedText copy = t1;
+        InternedText moved = std::move(t1);
+
+        REQUIRE(copy.use_count() == 2);
+        REQUIRE(t1.view().empty());
+        REQUIRE(table.text_bytes() == 5);
+    }
+
+    REQUIRE(table.size() == 0);
+    REQUIRE(table.text_bytes() == 0);
+}
+
+TEST_CASE("InternTable - text is stored in Paragraph")
+{
+    InternTable table;
+
+    InternedText short_text = table.intern("label");
+    InternedText long_text = table.intern(string(300, 'l'));
+
+    REQUIRE(short_text.paragraph()->capacity() == LegacyCode::Paragraph::inline_capacity);
+    REQUIRE(long_text.paragraph()->capacity() == SizeClassPool::block_size(301));
+    REQUIRE(long_text.view() == string(300, 'l'));
+    REQUIRE(InternedText{}.paragraph() == nullptr);
+}
+
+TEST_CASE("InternTable - text ends at embedded '\\0'")
+{
+    InternTable table;
+
+    InternedText label = table.intern("ab");
+
+    {
+        InternedText with_nul = table.intern("ab\0cd"sv);
+
+        REQUIRE(with_nul == label);
+        REQUIRE(with_nul.view() == "ab");
+        REQUIRE(table.size() == 1);
+    }
+
+    REQUIRE(table.size() == 1);
+    REQUIRE(table.text_bytes() == 2);
+    REQUIRE(table.intern("ab") == label);
+}
+
+TEST_CASE("InternTable - used by many threads")
+{
+    InternTable table;
+    vector<thread> threads;
+
+    for (int t = 0; t < 4; ++t)
+        threads.emplace_back([&table] {
+            for (int i = 0; i < 10'000; ++i)
+            {
+                InternedText text = table.intern("label " + to_string(i % 10));
+                InternedText copy = text;
+            }
+        });
+
+    for (auto& t : threads)
+        t.join();
+
+    REQUIRE(table.size() == 0);
+}
+
+TEST_CASE("Rope")
+{
+    Rope rope{"Hello world"};
+
+    SECTION("insert")
+    {
+        rope.insert(5, ",");
+        rope.append("!");
+        rope.insert(0, ">> ");
+
+        REQUIRE(rope.to_string() == ">> Hello, world!");
+        REQUIRE(rope.size() == 16);
+    }
+
+    SECTION("erase")
+    {
+        rope.erase(5, 6);
+        REQUIRE(rope.view() == "Hello");
+
+        rope.erase(2, 100);
+        REQUIRE(rope.view() == "He");
+    }
+
+    SECTION("position out of range")
+    {
+        REQUIRE_THROWS_AS(rope.insert(12, "x"), const std::out_of_range&);
+        REQUIRE_THROWS_AS(rope.erase(12, 1), const std::out_of_range&);
+    }
+
+    SECTION("long paragraph is split into chunks")
+    {
+        const string paragraph(10 * Rope::max_chunk_size, 'a');
+        Rope long_rope{paragraph};
+
+        REQUIRE(long_rope.no_of_chunks() > 10);
+
+        long_rope.insert(5000, "XYZ");
+        long_rope.erase(0, 1000);
+
+        string expected = paragraph;
+        expected.insert(5000, "XYZ");
+        expected.erase(0, 1000);
+
+        REQUIRE(long_rope.view() == expected);
+    }
+
+    SECTION("view is cached until next edit")
+    {
+        string_view v1 = rope.view();
+
+        AllocationCounter::Scope allocs;
+        string_view v2 = rope.view();
+        const size_t no_of_allocations = allocs.count(); // REQUIRE allocates
+
+        REQUIRE(no_of_allocations == 0);
+        REQUIRE(v1.data() == v2.data());
+    }
+
+    SECTION("move")
+    {
+        Rope target = std::move(rope);
+
+        REQUIRE(target.view() == "Hello world");
+        REQUIRE(rope.size() == 0);
+        REQUIRE(rope.view().empty());
+    }
+}
+
+TEST_CASE("Text - interned content")
+{
+    Text t1{1, 2, "shared label"};
+    Text t2{3, 4, "shared label"};
+
+    REQUIRE(t1.is_interned());
+    REQUIRE(t1.text_view().data() == t2.text_view().data());
+
+    SECTION("text_view does not allocate")
+    {
+        AllocationCounter::Scope allocs;
+
+        string_view text = t1.text_view();
+        const size_t no_of_allocations = allocs.count();
+
+        REQUIRE(no_of_allocations == 0);
+        REQUIRE(text == "shared label");
+    }
+
+    SECTION("copy of Text does not copy text")
+    {
+        AllocationCounter::Scope allocs;
+
+        Text copy = t1;
+        const size_t no_of_allocations = allocs.count();
+
+        REQUIRE(no_of_allocations == 0);
+        REQUIRE(copy.text_view().data() == t1.text_view().data());
+    }
+
+    SECTION("set_text")
+    {
+        t1.set_text("other label");
+
+        REQUIRE(t1.text() == "other label");
+        REQUIRE(t2.text() == "shared label");
+    }
+}
+
+TEST_CASE("Text - editing in place")
+{
+    Text t1{1, 2, "shared label"};
+    Text t2{3, 4, "shared label"};
+
+    t1.insert_text(0, "my ");
+    t1.erase_text(3, 7);
+
+    REQUIRE_FALSE(t1.is_interned());
+    REQUIRE(t1.text() == "my label");
+    REQUIRE(t2.text() == "shared label");
+
+    MemorySink sink;
+    RenderBatch batch{sink};
+    t1.draw(batch);
+    batch.flush();
+
+    REQUIRE(sink.content() == "Rendering text 'my label' at: [1, 2]\n");
+}
+
+TEST_CASE("Text - scene with 90% of duplicated labels", "[.][benchmark]")
+{
+    const size_t no_of_shapes = 100'000;
+    const size_t no_of_distinct_labels = no_of_shapes / 10;
+
+    vector<string> labels;
+    labels.reserve(no_of_shapes);
+    for (size_t i = 0; i < no_of_shapes; ++i)
+    {
+        const size_t id = i % no_of_distinct_labels;
+        labels.push_back("label #" + to_string(id) + string(id % 3 == 0 ? 80 : 20, '.'));
+    }
+
+    // counters are read before the description is built - it allocates too
+    const auto report = [](const char* description, size_t count, size_t bytes) {
+        cout << description << ": allocations = " << count << ", allocated = " << bytes / 1024 << " KB\n";
+    };
+
+    cout << "sizeof(Paragraph) = " << sizeof(LegacyCode::Paragraph) << ", sizeof(Text) = " << sizeof(Text) << "\n";
+
+    {
+        vector<LegacyCode::Paragraph> paragraphs;
+        paragraphs.reserve(no_of_shapes);
+
+        AllocationCounter::Scope allocs;
+        for (const auto& label : labels)
+            paragraphs.emplace_back(label.c_str(), label.size());
+
+        report("Paragraph per shape", allocs.count(), allocs.bytes());
+    }
+
+    {
+        vector<Text> scene;
+        scene.reserve(no_of_shapes);
+
+        AllocationCounter::Scope allocs;
+        for (size_t i = 0; i < no_of_shapes; ++i)
+            scene.emplace_back(static_cast<int>(i), 0, labels[i]);
+
+        report("Text - interned", allocs.count(), allocs.bytes());
+        cout << "  distinct texts = " << InternTable::global().size()
+             << ", text bytes = " << InternTable::global().text_bytes() / 1024 << " KB\n";
+
+        size_t total_length = 0;
+
+        AllocationCounter::Scope text_allocs;
+        for (const auto& shape : scene)
+            total_length += shape.text().size();
+        report("Text::text() for every shape", text_allocs.count(), text_allocs.bytes());
+
+        AllocationCounter::Scope view_allocs;
+        for (const auto& shape : scene)
+            total_length += shape.text_view().size();
+        report("Text::text_view() for every shape", view_allocs.count(), view_allocs.bytes());
+    }
+}
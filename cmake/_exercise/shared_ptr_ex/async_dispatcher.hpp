@@ -0,0 +1,304 @@
+#ifndef ASYNC_DISPATCHER_HPP_
+#define ASYNC_DISPATCHER_HPP_
+
+#include "event_subject.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////
+// Events::AsyncDispatcher<TEvent> - asynchronous notification of observers
+//
+// Dispatcher is an observer of a Subject<TEvent> - update() only puts the event into mailboxes of
+// its observers & returns. Observers are sharded across a fixed number of worker threads: every
+// observer belongs to one shard & gets events in the order of notifications.
+//
+// Mailbox of an observer holds at most queue_capacity events. When it is full:
+//  - Backpressure::drop - new event is dropped (counted by no_of_dropped())
+//  - Backpressure::block - notifying thread waits for the observer
+//  - Backpressure::coalesce - new event replaces the newest queued one, so after a burst slow observer
+//    gets the latest state (queue_capacity 1 - observer sees only the latest state)
+//
+// Exception thrown by an observer does not stop its shard - it is counted by no_of_errors().
+//
+// Observer must not notify the subject of its dispatcher with Backpressure::block - it would wait for itself.
+
+namespace Events
+{
+    enum class Backpressure
+    {
+        drop,
+        block,
+        coalesce
+    };
+
+    struct DispatchOptions
+    {
+        size_t no_of_shards = 2;
+        size_t queue_capacity = 64;
+        Backpressure backpressure = Backpressure::coalesce;
+    };
+
+    template <typename TEvent>
+    class AsyncDispatcher : public Observer<TEvent>
+    {
+        struct Mailbox
+        {
+            std::weak_ptr<Observer<TEvent>> observer;
+            std::deque<TEvent> events;
+            bool scheduled = false;
+            bool removed = false;
+        };
+
+        struct Shard
+        {
+            std::mutex mtx;
+            std::condition_variable work_cv;
+            std::condition_variable space_cv;
+            std::condition_variable idle_cv;
+            std::vector<std::shared_ptr<Mailbox>> mailboxes;
+            std::deque<std::shared_ptr<Mailbox>> ready;
+            bool busy = false;
+            bool done = false;
+            std::thread worker;
+        };
+
+        DispatchOptions options_;
+        std::vector<std::unique_ptr<Shard>> shards_;
+        std::atomic<size_t> no_of_dropped_{0};
+        std::atomic<size_t> no_of_errors_{0};
+
+        Shard& shard_of(const std::shared_ptr<Observer<TEvent>>& observer)
+        {
+            return *shards_[std::hash<const void*>{}(observer.get()) % shards_.size()];
+        }
+
+        // shard mutex must be locked
+        void enqueue(Shard& shard, std::unique_lock<std::mutex>& lk, Mailbox& mailbox, const TEvent& event)
+        {
+            if (mailbox.events.size() >= options_.queue_capacity)
+            {
+                switch (options_.backpressure)
+                {
+                case Backpressure::drop:
+                    no_of_dropped_.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                case Backpressure::coalesce:
+                    mailbox.events.back() = event;
+                    return;
+                case Backpressure::block:
+                    shard.space_cv.wait(lk, [&] { return mailbox.events.size() < options_.queue_capacity || mailbox.removed; });
+                    if (mailbox.removed)
+                        return;
+                    break;
+                }
+            }
+
+            mailbox.events.push_back(event);
+        }
+
+        void run(Shard& shard)
+        {
+            std::deque<TEvent> batch;
+
+            while (true)
+            {
+                std::shared_ptr<Mailbox> mailbox;
+                {
+                    std::unique_lock<std::mutex> lk{shard.mtx};
+                    shard.busy = false;
+                    shard.idle_cv.notify_all();
+
+                    shard.work_cv.wait(lk, [&] { return shard.done || !shard.ready.empty(); });
+                    if (shard.ready.empty())
+                        return;
+
+                    mailbox = std::move(shard.ready.front());
+                    shard.ready.pop_front();
+                    mailbox->scheduled = false;
+                    batch.swap(mailbox->events);
+                    shard.busy = true;
+                }
+                shard.space_cv.notify_all();
+
+                auto target = mailbox->observer.lock();
+
+                for (const TEvent& event : batch)
+                {
+                    if (!target)
+                        break;
+
+                    try
+                    {
+                        const EventText<TEvent> text{event};
+                        target->update(event, text);
+                    }
+                    catch (...)
+                    {
+                        no_of_errors_.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+
+                batch.clear();
+
+                if (!target)
+                    remove_mailbox(shard, mailbox);
+            }
+        }
+
+        void remove_mailbox(Shard& shard, const std::shared_ptr<Mailbox>& mailbox)
+        {
+            {
+                std::lock_guard<std::mutex> lk{shard.mtx};
+                mailbox->removed = true;
+                mailbox->events.clear();
+                shard.mailboxes.erase(std::remove(shard.mailboxes.begin(), shard.mailboxes.end(), mailbox), shard.mailboxes.end());
+            }
+            shard.space_cv.notify_all();
+        }
+
+    public:
+        explicit AsyncDispatcher(DispatchOptions options = {})
+            : options_{options}
+        {
+            if (options_.no_of_shards == 0 || options_.queue_capacity == 0)
+                throw std::invalid_argument("dispatcher needs at least one shard & queue of capacity > 0");
+
+            for (size_t i = 0; i < options_.no_of_shards; ++i)
+                shards_.push_back(std::make_unique<Shard>());
+
+            for (auto& shard : shards_)
+                shard->worker = std::thread{[this, &shard = *shard] { run(shard); }};
+        }
+
+        AsyncDispatcher(const AsyncDispatcher&) = delete;
+        AsyncDispatcher& operator=(const AsyncDispatcher&) = delete;
+
+        // delivers queued events & stops workers
+        ~AsyncDispatcher()
+        {
+            for (auto& shard : shards_)
+            {
+                {
+                    std::lock_guard<std::mutex> lk{shard->mtx};
+                    shard->done = true;
+                }
+                shard->work_cv.notify_all();
+            }
+
+            for (auto& shard : shards_)
+                shard->worker.join();
+        }
+
+        void register_observer(std::weak_ptr<Observer<TEvent>> observer)
+        {
+            auto target = observer.lock();
+            if (!target)
+                return;
+
+            Shard& shard = shard_of(target);
+            std::lock_guard<std::mutex> lk{shard.mtx};
+
+            for (const auto& mailbox : shard.mailboxes)
+                if (!mailbox->observer.owner_before(observer) && !observer.owner_before(mailbox->observer))
+                    return;
+
+            auto mailbox = std::make_shared<Mailbox>();
+            mailbox->observer = std::move(observer);
+            shard.mailboxes.push_back(std::move(mailbox));
+        }
+
+        // events queued for the observer are discarded
+        void unregister_observer(std::weak_ptr<Observer<TEvent>> observer)
+        {
+            auto target = observer.lock();
+            if (!target)
+                return;
+
+            Shard& shard = shard_of(target);
+            std::shared_ptr<Mailbox> found;
+            {
+                std::lock_guard<std::mutex> lk{shard.mtx};
+                for (const auto& mailbox : shard.mailboxes)
+                    if (!mailbox->observer.owner_before(observer) && !observer.owner_before(mailbox->observer))
+                        found = mailbox;
+            }
+
+            if (found)
+                remove_mailbox(shard, found);
+        }
+
+        // called by the subject - puts event into mailboxes of all observers
+        void update(const TEvent& event, const EventText<TEvent>&) override
+        {
+            for (auto& shard : shards_)
+            {
+                bool has_work = false;
+                {
+                    std::unique_lock<std::mutex> lk{shard->mtx};
+
+                    auto deliver = [&](const std::shared_ptr<Mailbox>& mailbox) {
+                        if (mailbox->removed)
+                            return;
+
+                        enqueue(*shard, lk, *mailbox, event);
+
+                        if (!mailbox->scheduled && !mailbox->events.empty())
+                        {
+                            mailbox->scheduled = true;
+                            shard->ready.push_back(mailbox);
+                            has_work = true;
+                        }
+                    };
+
+                    if (options_.backpressure == Backpressure::block)
+                    {
+                        // lock is released while waiting - list of mailboxes may change
+                        const auto mailboxes = shard->mailboxes;
+                        std::for_each(mailboxes.begin(), mailboxes.end(), deliver);
+                    }
+                    else
+                        std::for_each(shard->mailboxes.begin(), shard->mailboxes.end(), deliver);
+                }
+
+                if (has_work)
+                    shard->work_cv.notify_one();
+            }
+        }
+
+        // waits until all queued events are delivered
+        void wait_until_idle()
+        {
+            for (auto& shard : shards_)
+            {
+                std::unique_lock<std::mutex> lk{shard->mtx};
+                shard->idle_cv.wait(lk, [&] { return shard->ready.empty() && !shard->busy; });
+            }
+        }
+
+        size_t no_of_dropped() const noexcept
+        {
+            return no_of_dropped_.load(std::memory_order_relaxed);
+        }
+
+        // number of exceptions thrown by observers
+        size_t no_of_errors() const noexcept
+        {
+            return no_of_errors_.load(std::memory_order_relaxed);
+        }
+
+        const DispatchOptions& options() const noexcept
+        {
+            return options_;
+        }
+    };
+}
+
+#endif /*ASYNC_DISPATCHER_HPP_*/
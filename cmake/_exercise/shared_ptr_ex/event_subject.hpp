@@ -0,0 +1,111 @@
+#ifndef EVENT_SUBJECT_HPP_
+#define EVENT_SUBJECT_HPP_
+
+#include "observer_list.hpp"
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+////////////////////////////////////////////////////////////////////////////
+// Events::Subject<TEvent> - typed event channel
+//
+// Event is a small trivially copyable struct delivered to observers by const reference - nothing
+// is allocated per notification. Observers that need text call text.str() - the event is formatted
+// by format(const TEvent&, std::string&) (found by ADL) at most once per notification & only if
+// any observer asks for it.
+
+namespace Events
+{
+    template <typename TEvent>
+    class EventText
+    {
+        const TEvent& event_;
+        mutable std::string text_;
+        mutable bool formatted_ = false;
+
+    public:
+        explicit EventText(const TEvent& event) noexcept
+            : event_{event}
+        {
+        }
+
+        EventText(const EventText&) = delete;
+        EventText& operator=(const EventText&) = delete;
+
+        const std::string& str() const
+        {
+            if (!formatted_)
+            {
+                format(event_, text_);
+                formatted_ = true;
+            }
+
+            return text_;
+        }
+    };
+
+    template <typename TEvent>
+    class Observer
+    {
+    public:
+        virtual void update(const TEvent& event, const EventText<TEvent>& text) = 0;
+        virtual ~Observer() {}
+    };
+
+    // thread-safe - notification takes snapshot of observers without locks (see ObserverList)
+    template <typename TEvent>
+    class Subject
+    {
+        static_assert(std::is_trivially_copyable<TEvent>::value, "event must be trivially copyable");
+
+        ObserverList<Observer<TEvent>> observers_;
+
+    public:
+        void register_observer(std::weak_ptr<Observer<TEvent>> observer)
+        {
+            observers_.add(std::move(observer));
+        }
+
+        void unregister_observer(std::weak_ptr<Observer<TEvent>> observer)
+        {
+            observers_.remove(observer);
+        }
+
+        size_t no_of_observers() const
+        {
+            return observers_.size();
+        }
+
+    protected:
+        void notify(const TEvent& event)
+        {
+            const EventText<TEvent> text{event};
+            observers_.for_each([&](Observer<TEvent>& o) { o.update(event, text); });
+        }
+    };
+
+    struct StateChanged
+    {
+        int new_state;
+    };
+
+    inline void format(const StateChanged& event, std::string& text)
+    {
+        text = "Changed state on: " + std::to_string(event.new_state);
+    }
+
+    class StateSubject : public Subject<StateChanged>
+    {
+        std::atomic<int> state_{0};
+
+    public:
+        void set_state(int new_state)
+        {
+            if (state_.exchange(new_state) != new_state)
+                notify(StateChanged{new_state});
+        }
+    };
+}
+
+#endif /*EVENT_SUBJECT_HPP_*/
@@ -1,11 +1,22 @@
+#include "async_dispatcher.hpp"
+#include "event_subject.hpp"
+#include "observer_list.hpp"
 #include <cassert>
 #include <cstdlib>
 #include <iostream>
+#include <memory>
 #include <set>
 #include <stdexcept>
 #include <string>
 #include <list>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
 
 class Observer
 {
@@ -14,10 +25,11 @@ public:
     virtual ~Observer() {}
 };
 
+// thread-safe - notification takes snapshot of observers without locks (see ObserverList)
 class Subject
 {
-    int state_;
-    std::set<std::weak_ptr<Observer>, std::owner_less<std::weak_ptr<Observer>>> observers_;
+    std::atomic<int> state_;
+    ObserverList<Observer> observers_;
 
 public:
     Subject() : state_(0)
@@ -26,39 +38,37 @@ public:
 
     void register_observer(std::weak_ptr<Observer> observer)
     {
-        observers_.insert(std::move(observer));
+        observers_.add(std::move(observer));
     }
 
     void unregister_observer(std::weak_ptr<Observer> observer)
     {
-        observers_.erase(std::move(observer));
+        observers_.remove(observer);
     }
 
     void set_state(int new_state)
     {
-        if (state_ != new_state)
+        if (state_.exchange(new_state) != new_state)
         {
-            state_ = new_state;
-            notify("Changed state on: " + std::to_string(state_));
+            notify("Changed state on: " + std::to_string(new_state));
         }
     }
 
+    // expired observers are removed in batches - here all of them at once
+    void remove_expired_observers()
+    {
+        observers_.remove_expired();
+    }
+
+    size_t no_of_observers() const
+    {
+        return observers_.size();
+    }
+
 protected:
     void notify(const std::string& event_args)
     {
-        auto it = begin(observers_);
-        for(auto it = begin(observers_); it != end(observers_);)
-        {
-            if (auto target = it->lock())
-            {
-                target->update(event_args);
-                ++it;
-            }
-            else
-            {
-                it = observers_.erase(it);
-            }
-        }
+        observers_.for_each([&event_args](Observer& o) { o.update(event_args); });
     }
 };
 
@@ -91,10 +101,448 @@ public:
     }
 };
 
+namespace
+{
+    class CountingObserver : public Observer
+    {
+        std::atomic<size_t> no_of_updates_{0};
+
+    public:
+        void update(const std::string&) override
+        {
+            no_of_updates_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        size_t no_of_updates() const
+        {
+            return no_of_updates_.load();
+        }
+    };
+
+    void check(bool condition, const std::string& message)
+    {
+        if (!condition)
+            throw std::runtime_error("stress test failed: " + message);
+    }
+
+    // concurrent set_state() & register/unregister/expiry of observers
+    void stress_test()
+    {
+        const int no_of_notifiers = 4;
+        const int no_of_changers = 2;
+        const int notifications_per_thread = 20'000;
+
+        Subject s;
+        auto witness = std::make_shared<CountingObserver>();
+        s.register_observer(witness);
+
+        std::atomic<bool> done{false};
+        std::vector<std::thread> threads;
+
+        for (int t = 0; t < no_of_changers; ++t)
+            threads.emplace_back([&s, &done] {
+                std::vector<std::shared_ptr<CountingObserver>> alive(16);
+                for (size_t i = 0; !done; ++i)
+                {
+                    auto& slot = alive[i % alive.size()];
+                    if (slot && i % 2 == 0)
+                        s.unregister_observer(slot);
+                    slot = std::make_shared<CountingObserver>(); // every other observer just expires
+                    s.register_observer(slot);
+                }
+            });
+
+        // every thread sets unique states - every set_state() notifies
+        for (int t = 0; t < no_of_notifiers; ++t)
+            threads.emplace_back([&s, t] {
+                for (int i = 1; i <= notifications_per_thread; ++i)
+                    s.set_state(t * notifications_per_thread + i);
+            });
+
+        for (size_t i = no_of_changers; i < threads.size(); ++i)
+            threads[i].join();
+        done = true;
+        for (int i = 0; i < no_of_changers; ++i)
+            threads[i].join();
+
+        check(witness->no_of_updates() == size_t{no_of_notifiers * notifications_per_thread}, "witness missed notifications");
+
+        s.remove_expired_observers();
+        check(s.no_of_observers() == 1, "expired observers are not removed");
+
+        std::cout << "Stress test passed - " << witness->no_of_updates() << " notifications\n";
+    }
+
+    // previous implementation made thread-safe with a mutex held during notification
+    class LockedSubject
+    {
+        int state_ = 0;
+        std::set<std::weak_ptr<Observer>, std::owner_less<std::weak_ptr<Observer>>> observers_;
+        std::mutex mtx_;
+
+    public:
+        void register_observer(std::weak_ptr<Observer> observer)
+        {
+            std::lock_guard<std::mutex> lk{mtx_};
+            observers_.insert(std::move(observer));
+        }
+
+        void unregister_observer(std::weak_ptr<Observer> observer)
+        {
+            std::lock_guard<std::mutex> lk{mtx_};
+            observers_.erase(std::move(observer));
+        }
+
+        void set_state(int new_state)
+        {
+            std::lock_guard<std::mutex> lk{mtx_};
+            if (state_ != new_state)
+            {
+                state_ = new_state;
+                const std::string event_args = "Changed state on: " + std::to_string(state_);
+
+                for (auto it = begin(observers_); it != end(observers_);)
+                {
+                    if (auto target = it->lock())
+                    {
+                        target->update(event_args);
+                        ++it;
+                    }
+                    else
+                        it = observers_.erase(it);
+                }
+            }
+        }
+    };
+
+    // average time of set_state() - with & without concurrent registration of observers
+    template <typename TSubject>
+    void benchmark_notify(const char* description, size_t no_of_observers, bool with_registrations)
+    {
+        const int no_of_notifications = 1'000;
+
+        TSubject s;
+        std::vector<std::shared_ptr<CountingObserver>> observers;
+        for (size_t i = 0; i < no_of_observers; ++i)
+        {
+            observers.push_back(std::make_shared<CountingObserver>());
+            s.register_observer(observers.back());
+        }
+
+        std::atomic<bool> done{false};
+        std::thread registrations;
+        if (with_registrations)
+            registrations = std::thread{[&s, &done] {
+                while (!done)
+                {
+                    auto observer = std::make_shared<CountingObserver>();
+                    s.register_observer(observer);
+                    s.unregister_observer(observer);
+                }
+            }};
+
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 1; i <= no_of_notifications; ++i)
+            s.set_state(i);
+        const auto end = std::chrono::steady_clock::now();
+
+        done = true;
+        if (registrations.joinable())
+            registrations.join();
+
+        const double latency_us = std::chrono::duration<double, std::micro>(end - start).count() / no_of_notifications;
+        std::cout << description << " - " << no_of_observers << " observers" << (with_registrations ? ", concurrent registrations" : "")
+                  << ": notify latency = " << latency_us << " us\n";
+    }
+
+    // string-based path - state is parsed back from text
+    class ParsingObserver : public Observer
+    {
+    public:
+        long long sum = 0;
+
+        void update(const std::string& event) override
+        {
+            sum += std::atoi(event.c_str() + event.rfind(' ') + 1);
+        }
+    };
+
+    class StateObserver : public Events::Observer<Events::StateChanged>
+    {
+    public:
+        long long sum = 0;
+
+        void update(const Events::StateChanged& event, const Events::EventText<Events::StateChanged>&) override
+        {
+            sum += event.new_state;
+        }
+    };
+
+    class StateTextObserver : public Events::Observer<Events::StateChanged>
+    {
+    public:
+        size_t length = 0;
+
+        void update(const Events::StateChanged&, const Events::EventText<Events::StateChanged>& text) override
+        {
+            length += text.str().size();
+        }
+    };
+
+    template <typename TSubject, typename TObserver>
+    void benchmark_events(const char* description, size_t no_of_observers)
+    {
+        const int no_of_notifications = static_cast<int>(std::max<size_t>(10, 2'000'000 / no_of_observers));
+
+        TSubject s;
+        std::vector<std::shared_ptr<TObserver>> observers;
+        for (size_t i = 0; i < no_of_observers; ++i)
+        {
+            observers.push_back(std::make_shared<TObserver>());
+            s.register_observer(observers.back());
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 1; i <= no_of_notifications; ++i)
+            s.set_state(i);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << description << " - " << no_of_observers << " observers: "
+                  << static_cast<size_t>(no_of_notifications / seconds) << " notifications/s\n";
+    }
+
+    // records delivered states - read only after AsyncDispatcher::wait_until_idle()
+    class RecordingObserver : public Events::Observer<Events::StateChanged>
+    {
+        std::chrono::microseconds delay_;
+
+    public:
+        std::vector<int> states;
+
+        explicit RecordingObserver(std::chrono::microseconds delay = std::chrono::microseconds{0})
+            : delay_{delay}
+        {
+        }
+
+        void update(const Events::StateChanged& event, const Events::EventText<Events::StateChanged>&) override
+        {
+            if (delay_.count() > 0)
+                std::this_thread::sleep_for(delay_);
+
+            states.push_back(event.new_state);
+        }
+    };
+
+    class ThrowingObserver : public Events::Observer<Events::StateChanged>
+    {
+    public:
+        void update(const Events::StateChanged& event, const Events::EventText<Events::StateChanged>&) override
+        {
+            if (event.new_state % 2 == 0)
+                throw std::runtime_error("observer failed");
+        }
+    };
+
+    void async_dispatch_test()
+    {
+        using namespace Events;
+
+        const int no_of_states = 200;
+        const auto slow = std::chrono::microseconds{500};
+
+        auto is_increasing = [](const std::vector<int>& states) {
+            return std::adjacent_find(states.begin(), states.end(), std::greater_equal<int>{}) == states.end();
+        };
+
+        // every observer gets all states in order
+        {
+            StateSubject s;
+            auto dispatcher = std::make_shared<AsyncDispatcher<StateChanged>>(DispatchOptions{2, 4, Backpressure::block});
+            s.register_observer(dispatcher);
+
+            std::vector<std::shared_ptr<RecordingObserver>> observers;
+            for (int i = 0; i < 8; ++i)
+            {
+                observers.push_back(std::make_shared<RecordingObserver>(std::chrono::microseconds{i % 2 == 0 ? 0 : 50}));
+                dispatcher->register_observer(observers.back());
+            }
+
+            for (int state = 1; state <= no_of_states; ++state)
+                s.set_state(state);
+            dispatcher->wait_until_idle();
+
+            for (const auto& o : observers)
+                check(o->states.size() == no_of_states && is_increasing(o->states), "block - states lost or reordered");
+        }
+
+        // slow observer gets increasing subset of states - the rest is counted as dropped
+        {
+            StateSubject s;
+            auto dispatcher = std::make_shared<AsyncDispatcher<StateChanged>>(DispatchOptions{1, 8, Backpressure::drop});
+            s.register_observer(dispatcher);
+
+            auto observer = std::make_shared<RecordingObserver>(slow);
+            dispatcher->register_observer(observer);
+
+            for (int state = 1; state <= no_of_states; ++state)
+                s.set_state(state);
+            dispatcher->wait_until_idle();
+
+            check(is_increasing(observer->states), "drop - states reordered");
+            check(observer->states.size() + dispatcher->no_of_dropped() == no_of_states, "drop - states not counted");
+            check(dispatcher->no_of_dropped() > 0, "drop - slow observer got all states");
+        }
+
+        // slow observer sees the latest state after a burst
+        {
+            StateSubject s;
+            auto dispatcher = std::make_shared<AsyncDispatcher<StateChanged>>(DispatchOptions{1, 1, Backpressure::coalesce});
+            s.register_observer(dispatcher);
+
+            auto observer = std::make_shared<RecordingObserver>(slow);
+            dispatcher->register_observer(observer);
+
+            for (int state = 1; state <= no_of_states; ++state)
+                s.set_state(state);
+            dispatcher->wait_until_idle();
+
+            check(is_increasing(observer->states), "coalesce - states reordered");
+            check(observer->states.back() == no_of_states, "coalesce - latest state lost");
+            check(observer->states.size() < no_of_states, "coalesce - states not coalesced");
+        }
+
+        // exceptions of observers are counted - other observers of the shard get all states
+        {
+            StateSubject s;
+            auto dispatcher = std::make_shared<AsyncDispatcher<StateChanged>>(DispatchOptions{1, 4, Backpressure::block});
+            s.register_observer(dispatcher);
+
+            auto throwing_observer = std::make_shared<ThrowingObserver>();
+            auto observer = std::make_shared<RecordingObserver>();
+            dispatcher->register_observer(throwing_observer);
+            dispatcher->register_observer(observer);
+
+            for (int state = 1; state <= no_of_states; ++state)
+                s.set_state(state);
+            dispatcher->wait_until_idle();
+
+            check(dispatcher->no_of_errors() == no_of_states / 2, "errors - exceptions of observer not counted");
+            check(observer->states.size() == no_of_states, "errors - exception stopped the shard");
+        }
+
+        std::cout << "Async dispatch test passed\n";
+    }
+
+    // time of set_state() seen by producer - one observer takes 1 ms per event
+    template <typename TSetup>
+    void benchmark_producer_latency(const char* description, TSetup setup)
+    {
+        const int no_of_states = 200;
+
+        Events::StateSubject s;
+        auto slow_observer = std::make_shared<RecordingObserver>(std::chrono::milliseconds{1});
+        std::vector<std::shared_ptr<RecordingObserver>> fast_observers(10);
+        for (auto& o : fast_observers)
+            o = std::make_shared<RecordingObserver>();
+
+        auto dispatcher = setup(s, slow_observer, fast_observers);
+
+        double max_latency_us = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (int state = 1; state <= no_of_states; ++state)
+        {
+            const auto notify_start = std::chrono::steady_clock::now();
+            s.set_state(state);
+            max_latency_us = std::max(max_latency_us, std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - notify_start).count());
+        }
+        const double avg_latency_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / no_of_states;
+
+        if (dispatcher)
+            dispatcher->wait_until_idle();
+
+        std::cout << description << ": producer latency avg = " << avg_latency_us << " us, max = " << max_latency_us
+                  << " us, slow observer got " << slow_observer->states.size() << " events\n";
+    }
+
+    void benchmark_async_dispatch()
+    {
+        using namespace Events;
+        using Dispatcher = std::shared_ptr<AsyncDispatcher<StateChanged>>;
+
+        benchmark_producer_latency("synchronous", [](auto& s, auto& slow, auto& fast) {
+            s.register_observer(slow);
+            for (auto& o : fast)
+                s.register_observer(o);
+            return Dispatcher{};
+        });
+
+        for (auto [description, backpressure] : {std::pair{"async - drop", Backpressure::drop},
+                 std::pair{"async - block", Backpressure::block}, std::pair{"async - coalesce", Backpressure::coalesce}})
+        {
+            benchmark_producer_latency(description, [backpressure = backpressure](auto& s, auto& slow, auto& fast) {
+                auto dispatcher = std::make_shared<AsyncDispatcher<StateChanged>>(DispatchOptions{2, 64, backpressure});
+                s.register_observer(dispatcher);
+                dispatcher->register_observer(slow);
+                for (auto& o : fast)
+                    dispatcher->register_observer(o);
+                return dispatcher;
+            });
+        }
+    }
+
+    void benchmark()
+    {
+        for (size_t no_of_observers : {1'000, 10'000})
+            for (bool with_registrations : {false, true})
+            {
+                benchmark_notify<LockedSubject>("std::set + mutex", no_of_observers, with_registrations);
+                benchmark_notify<Subject>("ObserverList", no_of_observers, with_registrations);
+            }
+
+        for (size_t no_of_observers : {10, 1'000, 100'000})
+        {
+            benchmark_events<Subject, ParsingObserver>("std::string event", no_of_observers);
+            benchmark_events<Events::StateSubject, StateObserver>("Events::StateChanged", no_of_observers);
+            benchmark_events<Events::StateSubject, StateTextObserver>("Events::StateChanged - text", no_of_observers);
+        }
+
+        benchmark_async_dispatch();
+    }
+}
+
+// --stress - runs concurrent stress test, --async-test - checks ordering of async dispatch, --benchmark - measures notify latency & throughput
 int main(int argc, char const* argv[])
 {
     using namespace std;
 
+    const string mode = argc > 1 ? argv[1] : "";
+
+    try
+    {
+        if (mode == "--stress")
+        {
+            stress_test();
+            return EXIT_SUCCESS;
+        }
+
+        if (mode == "--async-test")
+        {
+            async_dispatch_test();
+            return EXIT_SUCCESS;
+        }
+
+        if (mode == "--benchmark")
+        {
+            benchmark();
+            return EXIT_SUCCESS;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        cout << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
     Subject s;
 
     auto o1 = make_shared<ConcreteObserver1>();
@@ -113,4 +561,19 @@ int main(int argc, char const* argv[])
     }
 
     s.set_state(2);
+
+    // typed events - text is formatted only for observers that ask for it
+    class StatePrinter : public Events::Observer<Events::StateChanged>
+    {
+    public:
+        void update(const Events::StateChanged&, const Events::EventText<Events::StateChanged>& text) override
+        {
+            cout << "StatePrinter: " << text.str() << endl;
+        }
+    };
+
+    Events::StateSubject typed_subject;
+    auto printer = make_shared<StatePrinter>();
+    typed_subject.register_observer(printer);
+    typed_subject.set_state(3);
 }
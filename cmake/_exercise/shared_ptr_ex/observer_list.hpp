@@ -0,0 +1,189 @@
+#ifndef OBSERVER_LIST_HPP_
+#define OBSERVER_LIST_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////
+// ObserverList<T> - copy-on-write list of weak_ptrs to observers
+//
+// for_each() takes no locks - it counts itself as an active reader & walks the current snapshot.
+// add() & remove() copy the snapshot under a mutex (writers only) & publish the copy.
+// Replaced snapshot is deleted when no reader is active - by the next writer or by the last
+// reader leaving (only if the mutex is free - readers never wait).
+//
+// Expired observers are skipped by for_each(). They are removed in batches - while writers copy
+// the snapshot or when readers have seen compaction_threshold of them.
+
+template <typename T>
+class ObserverList
+{
+    using Snapshot = std::vector<std::weak_ptr<T>>;
+
+    std::atomic<const Snapshot*> current_;
+    mutable std::atomic<size_t> active_readers_ {0};
+    std::atomic<size_t> expired_seen_ {0};
+    std::atomic<bool> has_retired_ {false};
+
+    std::mutex write_mtx_;
+    std::vector<const Snapshot*> retired_; // guarded by write_mtx_
+
+    static bool same_owner(const std::weak_ptr<T>& a, const std::weak_ptr<T>& b) noexcept
+    {
+        return !a.owner_before(b) && !b.owner_before(a);
+    }
+
+    // copy of current snapshot without expired observers - write_mtx_ must be locked
+    Snapshot copy_alive() const
+    {
+        const Snapshot& current = *current_.load();
+
+        Snapshot copy;
+        copy.reserve(current.size() + 1);
+        std::copy_if(current.begin(), current.end(), std::back_inserter(copy), [](const auto& o) { return !o.expired(); });
+
+        return copy;
+    }
+
+    // write_mtx_ must be locked
+    void publish(Snapshot snapshot)
+    {
+        const Snapshot* old = current_.exchange(new Snapshot(std::move(snapshot)));
+        expired_seen_.store(0);
+
+        retired_.push_back(old);
+        has_retired_.store(true);
+
+        reclaim();
+    }
+
+    // replaced snapshots are deleted if no reader is active - write_mtx_ must be locked
+    //
+    // reader increments active_readers_ before it loads current_ & writer reads the counter after
+    // exchange of current_ (both seq_cst) - zero means that nobody still reads retired snapshots
+    void reclaim() noexcept
+    {
+        if (retired_.empty() || active_readers_.load() != 0)
+            return;
+
+        for (const Snapshot* snapshot : retired_)
+            delete snapshot;
+
+        retired_.clear();
+        has_retired_.store(false);
+    }
+
+    void try_reclaim() noexcept
+    {
+        std::unique_lock<std::mutex> lk {write_mtx_, std::try_to_lock};
+        if (lk.owns_lock())
+            reclaim();
+    }
+
+    void try_compact()
+    {
+        std::unique_lock<std::mutex> lk {write_mtx_, std::try_to_lock};
+        if (lk.owns_lock() && expired_seen_.load() >= compaction_threshold)
+            publish(copy_alive());
+    }
+
+public:
+    // number of expired observers seen by readers that starts their removal
+    static constexpr size_t compaction_threshold = 64;
+
+    ObserverList()
+        : current_ {new Snapshot}
+    {
+    }
+
+    ObserverList(const ObserverList&) = delete;
+    ObserverList& operator=(const ObserverList&) = delete;
+
+    // no reader may be active
+    ~ObserverList()
+    {
+        delete current_.load();
+
+        for (const Snapshot* snapshot : retired_)
+            delete snapshot;
+    }
+
+    // observer already on the list is not added again
+    void add(std::weak_ptr<T> observer)
+    {
+        std::lock_guard<std::mutex> lk {write_mtx_};
+
+        Snapshot snapshot = copy_alive();
+        if (std::none_of(snapshot.begin(), snapshot.end(), [&](const auto& o) { return same_owner(o, observer); }))
+            snapshot.push_back(std::move(observer));
+
+        publish(std::move(snapshot));
+    }
+
+    void remove(const std::weak_ptr<T>& observer)
+    {
+        std::lock_guard<std::mutex> lk {write_mtx_};
+
+        Snapshot snapshot = copy_alive();
+        snapshot.erase(std::remove_if(snapshot.begin(), snapshot.end(), [&](const auto& o) { return same_owner(o, observer); }),
+            snapshot.end());
+
+        publish(std::move(snapshot));
+    }
+
+    void remove_expired()
+    {
+        std::lock_guard<std::mutex> lk {write_mtx_};
+        publish(copy_alive());
+    }
+
+    // f(T&) is called for every alive observer of the snapshot taken at the call
+    // f may call add() & remove() - changes are visible for next calls of for_each()
+    template <typename TFunction>
+    void for_each(TFunction f)
+    {
+        struct ReaderGuard
+        {
+            ObserverList& list;
+
+            ~ReaderGuard()
+            {
+                if (list.active_readers_.fetch_sub(1) == 1 && list.has_retired_.load())
+                    list.try_reclaim();
+            }
+        };
+
+        size_t expired = 0;
+        {
+            active_readers_.fetch_add(1);
+            ReaderGuard guard {*this};
+
+            for (const auto& observer : *current_.load())
+            {
+                if (auto target = observer.lock())
+                    f(*target);
+                else
+                    ++expired;
+            }
+        }
+
+        if (expired > 0 && expired_seen_.fetch_add(expired) + expired >= compaction_threshold)
+            try_compact();
+    }
+
+    // observers in the current snapshot - expired ones that are not removed yet included
+    size_t size() const
+    {
+        active_readers_.fetch_add(1);
+        const size_t result = current_.load()->size();
+        active_readers_.fetch_sub(1);
+
+        return result;
+    }
+};
+
+#endif /*OBSERVER_LIST_HPP_*/
@@ -1,10 +1,10 @@
 #include "catch.hpp"
+#include "task_queue.hpp"
 #include <iostream>
 #include <memory>
 #include <set>
 #include <string>
 #include <vector>
-#include <queue>
 
 using namespace std;
 using namespace Catch::Matchers;
@@ -230,37 +230,16 @@ struct Printer
     }
 };
 
-using Task = std::function<void()>;
-
-class TaskQueue
-{
-    std::queue<Task> q_;
-public:
-    template <typename Callable>
-    void submit(Callable&& callable)
-    {
-        q_.push(std::forward<Callable>(callable));
-    }
-
-    void run()
-    {
-        while(!q_.empty())
-        {
-            q_.front()();
-            q_.pop();
-        }
-    }
-};
-
 TEST_CASE("using TaskQueue")
 {
-    TaskQueue tasks;
+    TaskQueue tasks {0}; // no workers - tasks wait for run()
 
     Printer prn;
 
     Task printer = [&prn] { prn.print("Text"); };
     tasks.submit([] { std::cout << "Start...\n"; });
-    tasks.submit(printer);
+    tasks.submit(std::move(printer));
+    tasks.submit([ptr = std::make_unique<std::string>("Move-only")] { std::cout << *ptr << "\n"; });
     tasks.submit([] { std::cout << "End...\n"; });
 
     // later
@@ -0,0 +1,200 @@
+#ifndef TASK_HPP
+#define TASK_HPP
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+////////////////////////////////////////////////////////////////////////////
+// BasicTask<BufferSize> - move-only callable object void()
+//
+// Unlike std::function the callable does not have to be copyable - closures that own unique_ptrs,
+// packaged_tasks, etc. can be stored. Callable that fits_inline (not larger than BufferSize, not
+// over-aligned & nothrow move constructible) is stored in the buffer inside of the task - nothing
+// is allocated. Other callables are allocated on the heap.
+//
+// Task = BasicTask<48> - sizeof(Task) == 64 (one cache line).
+
+template <size_t BufferSize>
+class BasicTask
+{
+    static_assert(BufferSize >= sizeof(void*), "buffer must be able to hold a pointer");
+
+    struct Operations
+    {
+        void (*invoke)(void* storage);
+        void (*relocate)(void* target, void* source) noexcept; // move-constructs target & destroys source
+        void (*destroy)(void* storage) noexcept;
+        bool is_inline;
+    };
+
+    template <typename F>
+    struct InlineOperations
+    {
+        static F& callable(void* storage) noexcept
+        {
+            return *std::launder(static_cast<F*>(storage));
+        }
+
+        static void invoke(void* storage)
+        {
+            callable(storage)();
+        }
+
+        static void relocate(void* target, void* source) noexcept
+        {
+            ::new (target) F(std::move(callable(source)));
+            callable(source).~F();
+        }
+
+        static void destroy(void* storage) noexcept
+        {
+            callable(storage).~F();
+        }
+
+        static constexpr Operations table {&invoke, &relocate, &destroy, true};
+    };
+
+    // buffer holds pointer to the callable
+    template <typename F>
+    struct HeapOperations
+    {
+        static F* callable(void* storage) noexcept
+        {
+            return *std::launder(static_cast<F**>(storage));
+        }
+
+        static void invoke(void* storage)
+        {
+            (*callable(storage))();
+        }
+
+        static void relocate(void* target, void* source) noexcept
+        {
+            ::new (target) F*(callable(source));
+        }
+
+        static void destroy(void* storage) noexcept
+        {
+            delete callable(storage);
+        }
+
+        static constexpr Operations table {&invoke, &relocate, &destroy, false};
+    };
+
+    const Operations* operations_ = nullptr;
+    alignas(std::max_align_t) unsigned char storage_[BufferSize];
+
+public:
+    static constexpr size_t buffer_size = BufferSize;
+
+    // callable of type F is stored without allocation
+    template <typename F>
+    static constexpr bool fits_inline = sizeof(F) <= BufferSize
+        && alignof(F) <= alignof(std::max_align_t)
+        && std::is_nothrow_move_constructible_v<F>;
+
+    BasicTask() noexcept = default;
+
+    BasicTask(std::nullptr_t) noexcept
+    {
+    }
+
+    template <typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, BasicTask> && std::is_invocable_v<std::decay_t<F>&>>>
+    BasicTask(F&& f)
+    {
+        using Callable = std::decay_t<F>;
+
+        if constexpr (std::is_pointer_v<Callable>)
+        {
+            if (f == nullptr)
+                return;
+        }
+
+        if constexpr (fits_inline<Callable>)
+        {
+            ::new (static_cast<void*>(storage_)) Callable(std::forward<F>(f));
+            operations_ = &InlineOperations<Callable>::table;
+        }
+        else
+        {
+            ::new (static_cast<void*>(storage_)) Callable*(new Callable(std::forward<F>(f)));
+            operations_ = &HeapOperations<Callable>::table;
+        }
+    }
+
+    BasicTask(const BasicTask&) = delete;
+    BasicTask& operator=(const BasicTask&) = delete;
+
+    BasicTask(BasicTask&& other) noexcept
+    {
+        if (other.operations_)
+        {
+            other.operations_->relocate(storage_, other.storage_);
+            operations_ = std::exchange(other.operations_, nullptr);
+        }
+    }
+
+    BasicTask& operator=(BasicTask&& other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+
+            if (other.operations_)
+            {
+                other.operations_->relocate(storage_, other.storage_);
+                operations_ = std::exchange(other.operations_, nullptr);
+            }
+        }
+
+        return *this;
+    }
+
+    BasicTask& operator=(std::nullptr_t) noexcept
+    {
+        reset();
+        return *this;
+    }
+
+    ~BasicTask()
+    {
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        if (operations_)
+        {
+            operations_->destroy(storage_);
+            operations_ = nullptr;
+        }
+    }
+
+    void operator()()
+    {
+        if (!operations_)
+            throw std::bad_function_call {};
+
+        operations_->invoke(storage_);
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return operations_ != nullptr;
+    }
+
+    // callable is stored in the buffer of the task
+    bool is_inline() const noexcept
+    {
+        return operations_ != nullptr && operations_->is_inline;
+    }
+};
+
+using Task = BasicTask<48>;
+
+static_assert(sizeof(Task) == 64, "Task should fill one cache line");
+
+#endif // TASK_HPP
@@ -0,0 +1,325 @@
+#ifndef TASK_QUEUE_HPP
+#define TASK_QUEUE_HPP
+
+#include "task.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////
+// TaskQueue - executor with work stealing
+//
+// Every worker has its own deque of tasks. Worker takes tasks from the back of its deque (the most
+// recent ones - still hot in cache) & when the deque is empty it steals from the front of deques of
+// other workers. Tasks submitted by a worker go to its own deque, tasks submitted by other threads
+// are spread round-robin over all deques.
+//
+//  - post() - fire & forget, task must not throw
+//  - submit() - result or exception of the task is passed by std::future
+//  - submit_batch() - range of tasks enqueued with one lock per deque
+//  - run() - calling thread executes tasks until all submitted tasks are finished
+//  - shutdown() (called by destructor) - new tasks are rejected, pending tasks (& tasks submitted by them)
+//    are executed & workers are joined; called by a task it only rejects new tasks - the rest is done
+//    by the destructor
+//
+// TaskQueue {0} has no workers - tasks are executed only by run().
+//
+// Tasks are move-only (see task.hpp) - small closures are queued without allocation.
+
+class TaskQueue
+{
+    struct alignas(64) WorkQueue
+    {
+        std::mutex mtx;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkQueue>> queues_;
+    std::vector<std::thread> workers_;
+
+    std::atomic<size_t> no_of_queued_ {0};     // tasks in deques - changed under the lock of the deque
+    std::atomic<size_t> no_of_unfinished_ {0}; // queued & running tasks
+    std::atomic<size_t> no_of_sleeping_ {0};
+    std::atomic<size_t> next_queue_ {0};
+    std::atomic<bool> accepting_ {true};
+
+    std::mutex sleep_mtx_;
+    std::condition_variable cv_;
+    bool done_ = false; // guarded by sleep_mtx_
+
+    // queue whose tasks are executed by this thread - worker or thread in run()
+    inline static thread_local const TaskQueue* current_owner_ = nullptr;
+    inline static thread_local size_t current_index_ = 0;
+
+    bool is_inside() const noexcept
+    {
+        return current_owner_ == this;
+    }
+
+    size_t next_index() noexcept
+    {
+        return is_inside() ? current_index_ : next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    }
+
+    // task is counted as unfinished - undone if it is rejected
+    void start(size_t count)
+    {
+        no_of_unfinished_.fetch_add(count);
+
+        if (!accepting_.load() && !is_inside())
+        {
+            finish(count);
+            throw std::logic_error("TaskQueue is shut down");
+        }
+    }
+
+    void finish(size_t count)
+    {
+        if (no_of_unfinished_.fetch_sub(count) == count)
+        {
+            std::lock_guard<std::mutex> lk {sleep_mtx_};
+            cv_.notify_all();
+        }
+    }
+
+    // threads that wait increment no_of_sleeping_ before they check no_of_queued_ - mutex is locked
+    // only when anybody sleeps
+    void wake_up(size_t count)
+    {
+        if (no_of_sleeping_.load() == 0)
+            return;
+
+        std::lock_guard<std::mutex> lk {sleep_mtx_};
+        if (count == 1)
+            cv_.notify_one();
+        else
+            cv_.notify_all();
+    }
+
+    // own deque is checked first (from the back), then other deques are robbed (from the front)
+    bool find_task(size_t index, Task& task)
+    {
+        const size_t no_of_queues = queues_.size();
+
+        for (size_t i = 0; i < no_of_queues; ++i)
+        {
+            WorkQueue& queue = *queues_[(index + i) % no_of_queues];
+            std::lock_guard<std::mutex> lk {queue.mtx};
+
+            if (queue.tasks.empty())
+                continue;
+
+            if (i == 0)
+            {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            }
+            else
+            {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+
+            no_of_queued_.fetch_sub(1);
+            return true;
+        }
+
+        return false;
+    }
+
+    // exception thrown by a task terminates the program - as in a worker thread
+    void execute(Task& task) noexcept
+    {
+        task();
+        task = nullptr;
+        finish(1);
+    }
+
+    void work(size_t index)
+    {
+        current_owner_ = this;
+        current_index_ = index;
+
+        Task task;
+        while (true)
+        {
+            if (find_task(index, task))
+            {
+                execute(task);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lk {sleep_mtx_};
+            no_of_sleeping_.fetch_add(1);
+            cv_.wait(lk, [this] { return done_ || no_of_queued_.load() > 0; });
+            no_of_sleeping_.fetch_sub(1);
+
+            if (done_ && no_of_queued_.load() == 0)
+                return;
+        }
+    }
+
+public:
+    static size_t default_no_of_workers() noexcept
+    {
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    explicit TaskQueue(size_t no_of_workers = default_no_of_workers())
+    {
+        const size_t no_of_queues = std::max<size_t>(1, no_of_workers);
+
+        queues_.reserve(no_of_queues);
+        for (size_t i = 0; i < no_of_queues; ++i)
+            queues_.push_back(std::make_unique<WorkQueue>());
+
+        workers_.reserve(no_of_workers);
+        for (size_t i = 0; i < no_of_workers; ++i)
+            workers_.emplace_back([this, i] { work(i); });
+    }
+
+    TaskQueue(const TaskQueue&) = delete;
+    TaskQueue& operator=(const TaskQueue&) = delete;
+
+    ~TaskQueue()
+    {
+        shutdown();
+    }
+
+    size_t no_of_workers() const noexcept
+    {
+        return workers_.size();
+    }
+
+    void post(Task task)
+    {
+        start(1);
+
+        WorkQueue& queue = *queues_[next_index()];
+        {
+            std::lock_guard<std::mutex> lk {queue.mtx};
+            queue.tasks.push_back(std::move(task));
+            no_of_queued_.fetch_add(1);
+        }
+
+        wake_up(1);
+    }
+
+    template <typename Callable>
+    auto submit(Callable&& callable)
+    {
+        using Result = std::invoke_result_t<std::decay_t<Callable>&>;
+
+        std::packaged_task<Result()> task {std::forward<Callable>(callable)};
+        auto result = task.get_future();
+
+        post([task = std::move(task)]() mutable { task(); });
+
+        return result;
+    }
+
+    // elements of the range are converted to tasks (std::make_move_iterator moves them) & split into chunks - one per deque
+    template <typename TIterator>
+    void submit_batch(TIterator first, TIterator last)
+    {
+        size_t remaining = std::distance(first, last);
+        if (remaining == 0)
+            return;
+
+        const size_t count = remaining;
+        start(count);
+
+        const size_t no_of_queues = queues_.size();
+        const size_t chunk_size = (count + no_of_queues - 1) / no_of_queues;
+        const size_t index = next_index();
+
+        for (size_t i = 0; remaining > 0; ++i)
+        {
+            const size_t size = std::min(chunk_size, remaining);
+
+            WorkQueue& queue = *queues_[(index + i) % no_of_queues];
+            {
+                std::lock_guard<std::mutex> lk {queue.mtx};
+                for (size_t j = 0; j < size; ++j, ++first)
+                    queue.tasks.emplace_back(*first);
+                no_of_queued_.fetch_add(size);
+            }
+
+            remaining -= size;
+        }
+
+        wake_up(count);
+    }
+
+    // must not be called by a task of this queue - it would wait for itself
+    void run()
+    {
+        if (is_inside())
+            throw std::logic_error("TaskQueue::run() called by a task");
+
+        const size_t index = next_index();
+
+        struct OwnerGuard
+        {
+            const TaskQueue* previous_owner = current_owner_;
+            size_t previous_index = current_index_;
+
+            ~OwnerGuard()
+            {
+                current_owner_ = previous_owner;
+                current_index_ = previous_index;
+            }
+        } guard;
+
+        current_owner_ = this;
+        current_index_ = index;
+
+        Task task;
+        while (no_of_unfinished_.load() > 0)
+        {
+            if (find_task(index, task))
+            {
+                execute(task);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lk {sleep_mtx_};
+            no_of_sleeping_.fetch_add(1);
+            cv_.wait(lk, [this] { return no_of_unfinished_.load() == 0 || no_of_queued_.load() > 0; });
+            no_of_sleeping_.fetch_sub(1);
+        }
+    }
+
+    void shutdown()
+    {
+        accepting_.store(false);
+
+        // task cannot wait for itself - workers are joined by the destructor
+        if (is_inside())
+            return;
+
+        run();
+
+        {
+            std::lock_guard<std::mutex> lk {sleep_mtx_};
+            if (done_)
+                return;
+            done_ = true;
+        }
+        cv_.notify_all();
+
+        for (auto& worker : workers_)
+            worker.join();
+    }
+};
+
+#endif // TASK_QUEUE_HPP
@@ -0,0 +1,265 @@
+#include "task_queue.hpp"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "catch.hpp"
+
+using namespace std;
+
+namespace
+{
+    thread_local size_t tiny_task_sink = 0;
+
+    void tiny_task()
+    {
+        ++tiny_task_sink;
+    }
+
+    // old TaskQueue - serial execution of std::functions
+    class SerialTaskQueue
+    {
+        std::queue<std::function<void()>> q_;
+
+    public:
+        void submit(std::function<void()> task)
+        {
+            q_.push(std::move(task));
+        }
+
+        void run()
+        {
+            while (!q_.empty())
+            {
+                q_.front()();
+                q_.pop();
+            }
+        }
+    };
+}
+
+TEST_CASE("TaskQueue - submit returns future")
+{
+    TaskQueue tasks {2};
+
+    auto answer = tasks.submit([] { return 42; });
+    auto error = tasks.submit([]() -> int { throw std::runtime_error("task failed"); });
+
+    REQUIRE(answer.get() == 42);
+    REQUIRE_THROWS_AS(error.get(), std::runtime_error);
+}
+
+TEST_CASE("TaskQueue - run waits for all tasks")
+{
+    TaskQueue tasks {3};
+    std::atomic<int> counter {0};
+
+    for (int i = 0; i < 10'000; ++i)
+        tasks.post([&counter] { counter.fetch_add(1, std::memory_order_relaxed); });
+
+    tasks.run();
+
+    REQUIRE(counter == 10'000);
+}
+
+TEST_CASE("TaskQueue - submit_batch")
+{
+    TaskQueue tasks {3};
+    std::atomic<int> sum {0};
+
+    std::vector<Task> batch;
+    for (int i = 1; i <= 1000; ++i)
+        batch.push_back([&sum, i] { sum += i; });
+
+    tasks.submit_batch(std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+    tasks.run();
+
+    REQUIRE(sum == 500'500);
+}
+
+TEST_CASE("TaskQueue - without workers tasks are executed by run()")
+{
+    TaskQueue tasks {0};
+    std::vector<int> order;
+
+    tasks.post([&order] { order.push_back(1); });
+    tasks.post([&order] { order.push_back(2); });
+
+    REQUIRE(order.empty());
+
+    tasks.run();
+
+    REQUIRE(order.size() == 2);
+}
+
+TEST_CASE("TaskQueue - idle workers steal tasks")
+{
+    const int no_of_children = 100;
+
+    TaskQueue tasks {4};
+    std::atomic<int> no_of_done {0};
+    std::atomic<bool> all_done_while_parent_was_busy {false};
+
+    // children are queued in the deque of the parent's worker, which is busy until they are done
+    tasks.post([&] {
+        for (int i = 0; i < no_of_children; ++i)
+            tasks.post([&no_of_done] { no_of_done.fetch_add(1); });
+
+        const auto deadline = chrono::steady_clock::now() + 10s;
+        while (no_of_done.load() < no_of_children && chrono::steady_clock::now() < deadline)
+            this_thread::yield();
+
+        all_done_while_parent_was_busy = no_of_done.load() == no_of_children;
+    });
+
+    tasks.run();
+
+    REQUIRE(all_done_while_parent_was_busy);
+}
+
+TEST_CASE("TaskQueue - shutdown")
+{
+    SECTION("drains pending tasks & tasks submitted by them")
+    {
+        std::atomic<int> counter {0};
+
+        {
+            TaskQueue tasks {2};
+
+            for (int i = 0; i < 1000; ++i)
+                tasks.post([&] {
+                    counter.fetch_add(1);
+                    tasks.post([&counter] { counter.fetch_add(1); });
+                });
+        }
+
+        REQUIRE(counter == 2000);
+    }
+
+    SECTION("called by a task")
+    {
+        std::atomic<int> counter {0};
+
+        {
+            TaskQueue tasks {2};
+
+            tasks.post([&] {
+                tasks.shutdown();
+                tasks.post([&counter] { counter.fetch_add(1); });
+            });
+            tasks.run();
+
+            REQUIRE_THROWS_AS(tasks.post([] {}), std::logic_error);
+        }
+
+        REQUIRE(counter == 1);
+    }
+
+    SECTION("new tasks are rejected")
+    {
+        TaskQueue tasks {2};
+        tasks.shutdown();
+
+        REQUIRE_THROWS_AS(tasks.post([] {}), std::logic_error);
+        REQUIRE_THROWS_AS(tasks.submit([] { return 1; }), std::logic_error);
+    }
+}
+
+TEST_CASE("TaskQueue - fine-grained tasks", "[.][benchmark]")
+{
+    const size_t no_of_tasks = 10'000'000;
+
+    auto report = [no_of_tasks](const char* description, chrono::steady_clock::time_point start) {
+        const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << description << ": " << static_cast<size_t>(no_of_tasks / seconds) << " tasks/s\n";
+    };
+
+    {
+        const auto start = chrono::steady_clock::now();
+
+        SerialTaskQueue tasks;
+        for (size_t i = 0; i < no_of_tasks; ++i)
+            tasks.submit(&tiny_task);
+        tasks.run();
+
+        report("serial std::queue<std::function>", start);
+    }
+
+    TaskQueue tasks;
+    cout << "TaskQueue - " << tasks.no_of_workers() << " workers\n";
+
+    {
+        const auto start = chrono::steady_clock::now();
+
+        for (size_t i = 0; i < no_of_tasks; ++i)
+            tasks.post(&tiny_task);
+        tasks.run();
+
+        report("TaskQueue - post", start);
+    }
+
+    {
+        const auto start = chrono::steady_clock::now();
+
+        const size_t batch_size = 10'000;
+        std::vector<void (*)()> batch(batch_size, &tiny_task);
+        for (size_t i = 0; i < no_of_tasks; i += batch_size)
+            tasks.submit_batch(batch.begin(), batch.end());
+        tasks.run();
+
+        report("TaskQueue - submit_batch", start);
+    }
+
+    {
+        const auto start = chrono::steady_clock::now();
+
+        // workers submit to their own deques
+        const size_t no_of_spawners = 100;
+        for (size_t i = 0; i < no_of_spawners; ++i)
+            tasks.post([&tasks, no_of_tasks, no_of_spawners] {
+                for (size_t j = 0; j < no_of_tasks / no_of_spawners; ++j)
+                    tasks.post(&tiny_task);
+            });
+        tasks.run();
+
+        report("TaskQueue - post by workers", start);
+    }
+}
+
+TEST_CASE("TaskQueue - parallel speedup", "[.][benchmark]")
+{
+    const size_t no_of_tasks = 20'000;
+
+    // ~20us of work
+    auto work = [] {
+        volatile double x = 1.0;
+        for (int i = 0; i < 5'000; ++i)
+            x = x * 1.000001 + 0.000001;
+    };
+
+    const size_t max_no_of_workers = 2 * TaskQueue::default_no_of_workers();
+    double single_worker_time = 0.0;
+
+    for (size_t no_of_workers = 1; no_of_workers <= max_no_of_workers; no_of_workers *= 2)
+    {
+        TaskQueue tasks {no_of_workers};
+
+        const auto start = chrono::steady_clock::now();
+
+        std::vector<decltype(work)> batch(no_of_tasks, work);
+        tasks.submit_batch(batch.begin(), batch.end());
+        tasks.run();
+
+        const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        if (no_of_workers == 1)
+            single_worker_time = seconds;
+
+        cout << no_of_workers << " workers: " << seconds * 1000 << " ms - speedup " << single_worker_time / seconds << "\n";
+    }
+}
@@ -0,0 +1,226 @@
+#include "allocation_counter.hpp"
+#include "task.hpp"
+#include "task_queue.hpp"
+#include <array>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "catch.hpp"
+
+using namespace std;
+
+namespace
+{
+    struct DestructionCounter
+    {
+        int* no_of_destructions;
+        bool moved_from = false;
+
+        explicit DestructionCounter(int* counter) noexcept
+            : no_of_destructions {counter}
+        {
+        }
+
+        DestructionCounter(DestructionCounter&& other) noexcept
+            : no_of_destructions {other.no_of_destructions}
+        {
+            other.moved_from = true;
+        }
+
+        ~DestructionCounter()
+        {
+            if (!moved_from)
+                ++*no_of_destructions;
+        }
+    };
+
+    // closure of Size bytes
+    template <size_t Size>
+    struct Payload
+    {
+        std::array<char, Size - sizeof(size_t*)> data {};
+        size_t* sink;
+
+        void operator()() const
+        {
+            *sink += static_cast<size_t>(data[0]) + 1;
+        }
+    };
+
+    struct ThrowingMove
+    {
+        ThrowingMove() = default;
+        ThrowingMove(ThrowingMove&&) noexcept(false) {}
+
+        void operator()() {}
+    };
+
+    struct alignas(64) OverAligned
+    {
+        void operator()() {}
+    };
+}
+
+TEST_CASE("Task - fits_inline")
+{
+    static_assert(Task::buffer_size == 48);
+    static_assert(Task::fits_inline<Payload<48>>);
+    static_assert(!Task::fits_inline<Payload<56>>);
+    static_assert(BasicTask<64>::fits_inline<Payload<64>>);
+    static_assert(!Task::fits_inline<ThrowingMove>);
+    static_assert(!Task::fits_inline<OverAligned>);
+
+    auto closure = [ptr = std::make_unique<int>(1)] { return *ptr; };
+    static_assert(Task::fits_inline<decltype(closure)>);
+}
+
+TEST_CASE("Task - small closures are not allocated")
+{
+    size_t sink = 0;
+
+    AllocationCounter::Scope allocs;
+
+    Task task {Payload<48> {{}, &sink}};
+    Task target = std::move(task);
+    target();
+    target = nullptr;
+
+    const size_t no_of_allocations = allocs.count();
+
+    REQUIRE(no_of_allocations == 0);
+    REQUIRE(sink == 1);
+}
+
+TEST_CASE("Task - move-only closure")
+{
+    auto text = std::make_unique<std::string>("text");
+    std::string result;
+
+    Task task = [&result, ptr = std::move(text)] { result = *ptr; };
+    REQUIRE(task.is_inline());
+
+    Task target = std::move(task);
+    REQUIRE_FALSE(task);
+
+    target();
+    REQUIRE(result == "text");
+}
+
+TEST_CASE("Task - large closures are allocated on the heap")
+{
+    size_t sink = 0;
+    Task task {Payload<128> {{}, &sink}};
+
+    REQUIRE(task);
+    REQUIRE_FALSE(task.is_inline());
+
+    AllocationCounter::Scope allocs;
+    Task target = std::move(task);
+    target();
+    const size_t no_of_allocations = allocs.count();
+
+    REQUIRE(no_of_allocations == 0);
+    REQUIRE(sink == 1);
+}
+
+TEST_CASE("Task - callable is destroyed once")
+{
+    int no_of_destructions = 0;
+
+    SECTION("inline")
+    {
+        {
+            Task task = [counter = DestructionCounter {&no_of_destructions}] {};
+            Task target = std::move(task);
+            task = std::move(target);
+        }
+
+        REQUIRE(no_of_destructions == 1);
+    }
+
+    SECTION("on the heap")
+    {
+        {
+            Task task = [counter = DestructionCounter {&no_of_destructions}, padding = std::array<char, 64> {}] {};
+            REQUIRE_FALSE(task.is_inline());
+
+            Task target = std::move(task);
+            task = std::move(target);
+        }
+
+        REQUIRE(no_of_destructions == 1);
+    }
+}
+
+TEST_CASE("Task - empty")
+{
+    Task task;
+    REQUIRE_FALSE(task);
+    REQUIRE_THROWS_AS(task(), std::bad_function_call);
+
+    void (*null_function)() = nullptr;
+    Task from_null_pointer {null_function};
+    REQUIRE_FALSE(from_null_pointer);
+}
+
+TEST_CASE("Task vs std::function - submit & run", "[.][benchmark]")
+{
+    const size_t no_of_tasks = 1'000'000;
+    size_t sink = 0;
+
+    auto report = [no_of_tasks](const string& description, chrono::steady_clock::time_point start, const AllocationCounter::Scope& allocs) {
+        const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << description << ": " << static_cast<size_t>(no_of_tasks / seconds) << " tasks/s, "
+             << static_cast<double>(allocs.count()) / no_of_tasks << " allocations/task\n";
+    };
+
+    // queue of tasks filled & run by one thread - std::deque allocates a node per 512 bytes
+    // (1/8 allocation per Task, 1/16 per std::function)
+    auto submit_and_run = [&](auto tag, const string& description, const auto& closure) {
+        using TTask = typename decltype(tag)::type;
+
+        AllocationCounter::Scope allocs;
+        const auto start = chrono::steady_clock::now();
+
+        std::deque<TTask> queue;
+        for (size_t i = 0; i < no_of_tasks; ++i)
+            queue.emplace_back(closure);
+
+        while (!queue.empty())
+        {
+            queue.front()();
+            queue.pop_front();
+        }
+
+        report(description, start, allocs);
+    };
+
+    auto task_queue_submit_and_run = [&](const string& description, const auto& closure) {
+        TaskQueue tasks {0};
+
+        AllocationCounter::Scope allocs;
+        const auto start = chrono::steady_clock::now();
+
+        for (size_t i = 0; i < no_of_tasks; ++i)
+            tasks.post(closure);
+        tasks.run();
+
+        report(description, start, allocs);
+    };
+
+    auto compare = [&](const string& size, const auto& closure) {
+        submit_and_run(std::common_type<std::function<void()>> {}, "std::function - " + size, closure);
+        submit_and_run(std::common_type<Task> {}, "Task - " + size, closure);
+        task_queue_submit_and_run("TaskQueue {0} - " + size, closure);
+    };
+
+    compare("16 bytes", Payload<16> {{}, &sink});
+    compare("48 bytes", Payload<48> {{}, &sink});
+    compare("128 bytes", Payload<128> {{}, &sink});
+
+    REQUIRE(sink == 9 * no_of_tasks);
+}
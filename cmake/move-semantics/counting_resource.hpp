@@ -0,0 +1,58 @@
+#ifndef COUNTING_RESOURCE_HPP
+#define COUNTING_RESOURCE_HPP
+
+#include <cstddef>
+#include <memory_resource>
+
+// memory resource that counts requests forwarded to upstream resource
+class CountingResource : public std::pmr::memory_resource
+{
+    std::pmr::memory_resource* upstream_;
+    size_t allocations_ {};
+    size_t deallocations_ {};
+    size_t bytes_in_use_ {};
+
+public:
+    explicit CountingResource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) noexcept
+        : upstream_ {upstream}
+    {
+    }
+
+    size_t allocations() const noexcept
+    {
+        return allocations_;
+    }
+
+    size_t deallocations() const noexcept
+    {
+        return deallocations_;
+    }
+
+    size_t bytes_in_use() const noexcept
+    {
+        return bytes_in_use_;
+    }
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        void* ptr = upstream_->allocate(bytes, alignment);
+        ++allocations_;
+        bytes_in_use_ += bytes;
+        return ptr;
+    }
+
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override
+    {
+        upstream_->deallocate(ptr, bytes, alignment);
+        ++deallocations_;
+        bytes_in_use_ -= bytes;
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+#endif // COUNTING_RESOURCE_HPP
@@ -0,0 +1,175 @@
+#ifndef COW_DATA_SET_HPP
+#define COW_DATA_SET_HPP
+
+#include "intrusive_ptr.hpp"
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////
+// CowDataSet - copy-on-write DataSet
+//
+// Copies share an immutable buffer (reference counted, safe to share between threads).
+// Buffer is cloned on first mutable access - non-const begin()/end()/operator[].
+// Use cbegin()/cend() to read a non-const object without cloning.
+//
+// After mutable access the buffer becomes unshareable - references & iterators
+// handed out may still modify it, so the next copy is a deep one.
+
+class CowDataSet
+{
+    struct Buffer : RefCounted<Buffer>
+    {
+        std::vector<int> items;
+
+        explicit Buffer(std::vector<int> items)
+            : items {std::move(items)}
+        {
+        }
+    };
+
+    std::string name_;
+    IntrusivePtr<Buffer> buffer_;
+    bool shareable_ = true;
+
+    static IntrusivePtr<Buffer> clone(const IntrusivePtr<Buffer>& buffer)
+    {
+        return MakeIntrusive<Buffer>(buffer ? buffer->items : std::vector<int> {});
+    }
+
+    void detach()
+    {
+        if (!buffer_ || buffer_.use_count() > 1)
+            buffer_ = clone(buffer_);
+
+        shareable_ = false;
+    }
+
+    template <typename TRange>
+    using RangeIterator = decltype(std::begin(std::declval<const TRange&>()));
+
+    // range of ints - strings & other ranges of values merely convertible to int are rejected
+    template <typename TRange, typename = void>
+    struct IsRangeOfInts : std::false_type
+    {
+    };
+
+    template <typename TRange>
+    struct IsRangeOfInts<TRange, std::void_t<RangeIterator<TRange>, decltype(std::end(std::declval<const TRange&>())),
+                                             typename std::iterator_traits<RangeIterator<TRange>>::iterator_category>>
+        : std::bool_constant<std::is_convertible_v<typename std::iterator_traits<RangeIterator<TRange>>::iterator_category,
+                                                   std::input_iterator_tag>
+              && std::is_same_v<typename std::iterator_traits<RangeIterator<TRange>>::value_type, int>>
+    {
+    };
+
+    template <typename TRange>
+    using RequireRangeOfInts = std::enable_if_t<IsRangeOfInts<TRange>::value>;
+
+public:
+    using iterator = int*;
+    using const_iterator = const int*;
+
+    CowDataSet(std::string name, std::initializer_list<int> list)
+        : name_ {std::move(name)}
+        , buffer_ {MakeIntrusive<Buffer>(std::vector<int>(list))}
+    {
+    }
+
+    // takes snapshot of any range of ints, e.g. DataSet
+    template <typename TRange, typename = RequireRangeOfInts<TRange>>
+    CowDataSet(std::string name, const TRange& items)
+        : name_ {std::move(name)}
+        , buffer_ {MakeIntrusive<Buffer>(std::vector<int>(std::begin(items), std::end(items)))}
+    {
+    }
+
+    CowDataSet(const CowDataSet& other)
+        : name_ {other.name_}
+        , buffer_ {other.shareable_ ? other.buffer_ : clone(other.buffer_)}
+    {
+    }
+
+    CowDataSet& operator=(const CowDataSet& other)
+    {
+        CowDataSet temp(other);
+        swap(temp);
+
+        return *this;
+    }
+
+    CowDataSet(CowDataSet&& other) noexcept = default;
+    CowDataSet& operator=(CowDataSet&& other) noexcept = default;
+
+    void swap(CowDataSet& other) noexcept
+    {
+        name_.swap(other.name_);
+        buffer_.swap(other.buffer_);
+        std::swap(shareable_, other.shareable_);
+    }
+
+    const std::string& name() const noexcept
+    {
+        return name_;
+    }
+
+    size_t size() const noexcept
+    {
+        return buffer_ ? buffer_->items.size() : 0;
+    }
+
+    // true if buffer is shared with other copies
+    bool is_shared() const noexcept
+    {
+        return buffer_.use_count() > 1;
+    }
+
+    iterator begin()
+    {
+        detach();
+        return buffer_->items.data();
+    }
+
+    iterator end()
+    {
+        detach();
+        return buffer_->items.data() + buffer_->items.size();
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return buffer_ ? buffer_->items.data() : nullptr;
+    }
+
+    const_iterator end() const noexcept
+    {
+        return begin() + size();
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept
+    {
+        return end();
+    }
+
+    int& operator[](size_t index)
+    {
+        detach();
+        return buffer_->items[index];
+    }
+
+    const int& operator[](size_t index) const
+    {
+        return buffer_->items[index];
+    }
+};
+
+#endif // COW_DATA_SET_HPP
@@ -0,0 +1,452 @@
+#ifndef DATA_SET_HPP
+#define DATA_SET_HPP
+
+#include "instrumentation.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory_resource>
+#include <string>
+#include <type_traits>
+
+////////////////////////////////////////////////////////////////////////////
+// DataSet - class with copy & move semantics (user provided implementation)
+//
+// Series with up to InlineCapacity items live in a buffer embedded in the object,
+// longer series are allocated from a memory resource. BasicDataSet<0> always allocates.
+//
+// Items can be ingested in bulk - from iterator ranges, contiguous ranges (pointer & size, std::vector,
+// std::array, ...) or a generator. Size known up front means one exact allocation, contiguous ints
+// are copied with memcpy. append() grows geometrically, so series can be built in chunks.
+//
+// Calls of special members are counted by Instrumented<BasicDataSet> (see instrumentation.hpp).
+//
+// Allocator follows std::pmr containers:
+// - copy constructor uses the default resource, move constructor takes the resource of the source
+// - assignments keep the resource of the target
+//   (move assignment copies items if resources are not equal)
+// - swap exchanges resources together with items
+
+template <size_t InlineCapacity>
+class BasicDataSet : public Instrumented<BasicDataSet<InlineCapacity>>
+{
+    using Instrumentation = Instrumented<BasicDataSet<InlineCapacity>>;
+
+public:
+    using allocator_type = std::pmr::polymorphic_allocator<int>;
+
+private:
+    std::string name_;
+    int* data_;
+    size_t size_;
+    size_t capacity_ {InlineCapacity};
+    std::pmr::memory_resource* resource_;
+    std::array<int, InlineCapacity> buffer_;
+
+    template <typename It>
+    using IteratorCategory = typename std::iterator_traits<It>::iterator_category;
+
+    template <typename It, typename = void>
+    struct IsInputIteratorOfInts : std::false_type
+    {
+    };
+
+    template <typename It>
+    struct IsInputIteratorOfInts<It, std::void_t<IteratorCategory<It>>>
+        : std::bool_constant<std::is_convertible_v<IteratorCategory<It>, std::input_iterator_tag>
+              && std::is_convertible_v<typename std::iterator_traits<It>::reference, int>>
+    {
+    };
+
+    template <typename It>
+    using RequireInputIterator = std::enable_if_t<IsInputIteratorOfInts<It>::value>;
+
+    template <typename TRange>
+    using RequireRange = std::void_t<decltype(std::begin(std::declval<const TRange&>())),
+                                     decltype(std::end(std::declval<const TRange&>()))>;
+
+    template <typename TRange, typename = void>
+    struct IsContiguousRangeOfInts : std::false_type
+    {
+    };
+
+    template <typename TRange>
+    struct IsContiguousRangeOfInts<TRange, std::void_t<decltype(std::data(std::declval<const TRange&>()))>>
+        : std::is_same<decltype(std::data(std::declval<const TRange&>())), const int*>
+    {
+    };
+
+    // generator called with index of an item: int gen(size_t)
+    template <typename TGenerator>
+    static constexpr bool is_item_generator_v = std::is_invocable_r_v<int, TGenerator&, size_t>;
+
+    // generator filling a block of items at once: void gen(int* dest, size_t count)
+    template <typename TGenerator>
+    static constexpr bool is_block_generator_v = std::is_invocable_v<TGenerator&, int*, size_t>;
+
+    template <typename TGenerator>
+    using RequireGenerator = std::enable_if_t<is_item_generator_v<TGenerator> || is_block_generator_v<TGenerator>>;
+
+    int* allocate(size_t capacity)
+    {
+        if (capacity <= InlineCapacity)
+            return buffer_.data();
+
+        return get_allocator().allocate(capacity);
+    }
+
+    void release() noexcept
+    {
+        if (!is_inline())
+            get_allocator().deallocate(data_, capacity_);
+    }
+
+    // storage for all items is allocated at once - capacity is not larger than needed
+    void init_storage(size_t capacity)
+    {
+        data_ = allocate(capacity);
+        capacity_ = std::max(capacity, InlineCapacity);
+    }
+
+    static int* copy_items(const int* first, size_t count, int* dest) noexcept
+    {
+        if (count != 0)
+            std::memcpy(dest, first, count * sizeof(int));
+
+        return dest + count;
+    }
+
+    template <typename InputIt>
+    static int* copy_items(InputIt first, InputIt last, int* dest)
+    {
+        if constexpr (std::is_same_v<InputIt, int*> || std::is_same_v<InputIt, const int*>)
+            return copy_items(first, static_cast<size_t>(last - first), dest);
+        else
+            return std::copy(first, last, dest);
+    }
+
+    // space for count more items - the first block is allocated with exact size,
+    // then storage grows geometrically, so appending in chunks is amortized O(1) per item
+    int* reserve_back(size_t count)
+    {
+        if (capacity_ - size_ < count)
+            reserve(size_ == 0 ? count : std::max(size_ + count, 2 * capacity_));
+
+        return data_ + size_;
+    }
+
+    // transfers items of other to this - heap buffer is stolen, inline buffer is copied
+    void steal(BasicDataSet& other) noexcept
+    {
+        size_ = other.size_;
+        capacity_ = other.capacity_;
+
+        if (other.is_inline())
+        {
+            if constexpr (InlineCapacity > 0) // otherwise inline series is empty
+                std::copy(other.begin(), other.end(), buffer_.data());
+            data_ = buffer_.data();
+        }
+        else
+            data_ = other.data_;
+
+        other.size_ = 0;
+        other.capacity_ = InlineCapacity;
+        other.data_ = other.buffer_.data();
+    }
+
+    // replaces items & name with a copy of other - strong exception guarantee
+    void assign(const BasicDataSet& other)
+    {
+        // decided by size of other - reserved capacity of other is not copied
+        std::string name = other.name_;
+        const size_t capacity = std::max(other.size_, InlineCapacity);
+        int* data = allocate(capacity);
+
+        release(); // noexcept from here
+        copy_items(other.data_, other.size_, data);
+        data_ = data;
+        size_ = other.size_;
+        capacity_ = capacity;
+        name_.swap(name);
+    }
+
+public:
+    using iterator = int*;
+    using const_iterator = const int*;
+
+    static constexpr size_t inline_capacity = InlineCapacity;
+
+    explicit BasicDataSet(std::string name, const allocator_type& alloc = {})
+        : name_ {std::move(name)}
+        , data_ {buffer_.data()}
+        , size_ {0}
+        , resource_ {alloc.resource()}
+    {
+    }
+
+    BasicDataSet(std::string name, std::initializer_list<int> list, const allocator_type& alloc = {})
+        : BasicDataSet(std::move(name), list.begin(), list.size(), alloc)
+    {
+    }
+
+    // contiguous block of items, e.g. a buffer received from a socket
+    BasicDataSet(std::string name, const int* items, size_t size, const allocator_type& alloc = {})
+        : name_ {std::move(name)}
+        , size_ {size}
+        , resource_ {alloc.resource()}
+    {
+        init_storage(size_);
+        copy_items(items, size_, data_);
+    }
+
+    // single pass input iterators cannot be measured up front - storage grows as in append()
+    template <typename InputIt, typename = RequireInputIterator<InputIt>>
+    BasicDataSet(std::string name, InputIt first, InputIt last, const allocator_type& alloc = {})
+        : BasicDataSet(std::move(name), alloc)
+    {
+        append(first, last);
+    }
+
+    template <typename TRange, typename = RequireRange<TRange>>
+    BasicDataSet(std::string name, const TRange& items, const allocator_type& alloc = {})
+        : BasicDataSet(std::move(name), alloc)
+    {
+        append(items);
+    }
+
+    // size & generator - items are written directly to the storage of DataSet
+    template <typename TGenerator, typename = RequireGenerator<TGenerator>>
+    BasicDataSet(std::string name, size_t size, TGenerator generator, const allocator_type& alloc = {})
+        : BasicDataSet(std::move(name), alloc)
+    {
+        reserve(size);
+        append(size, std::move(generator));
+    }
+
+    BasicDataSet(const BasicDataSet& other)
+        : BasicDataSet(other, allocator_type {})
+    {
+    }
+
+    BasicDataSet(const BasicDataSet& other, const allocator_type& alloc)
+        : Instrumentation(other)
+        , name_(other.name_)
+        , size_(other.size_)
+        , resource_ {alloc.resource()}
+    {
+        init_storage(size_);
+        copy_items(other.data_, size_, data_);
+    }
+
+    void swap(BasicDataSet& other) noexcept
+    {
+        const bool this_inline = is_inline();
+        const bool other_inline = other.is_inline();
+
+        name_.swap(other.name_);
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        std::swap(capacity_, other.capacity_);
+        std::swap(resource_, other.resource_);
+        std::swap(buffer_, other.buffer_);
+
+        // pointers to inline buffers must follow the swapped items
+        if (other_inline)
+            data_ = buffer_.data();
+        if (this_inline)
+            other.data_ = other.buffer_.data();
+    }
+
+    BasicDataSet& operator=(const BasicDataSet& other)
+    {
+        if (this != &other)
+        {
+            assign(other);
+            Instrumentation::operator=(other);
+        }
+
+        return *this;
+    }
+
+    BasicDataSet(BasicDataSet&& other) noexcept
+        : Instrumentation(std::move(other)) // noexcept
+        , name_ {std::move(other.name_)} // noexcept
+        , resource_ {other.resource_} // noexcept
+    {
+        steal(other); // noexcept
+    }
+
+    BasicDataSet(BasicDataSet&& other, const allocator_type& alloc)
+        : Instrumentation(std::move(other))
+        , name_ {std::move(other.name_)}
+        , resource_ {alloc.resource()}
+    {
+        if (other.is_inline() || get_allocator() == other.get_allocator())
+            steal(other);
+        else
+        {
+            size_ = other.size_;
+            init_storage(size_);
+            copy_items(other.data_, size_, data_);
+        }
+    }
+
+    BasicDataSet& operator=(BasicDataSet&& other)
+    {
+        if (this != &other)
+        {
+            if (get_allocator() != other.get_allocator())
+                assign(other);
+            else
+            {
+                release();
+
+                name_ = std::move(other.name_);
+                steal(other);
+            }
+
+            Instrumentation::operator=(std::move(other));
+        }
+        return *this;
+    }
+
+    ~BasicDataSet()
+    {
+        release();
+    }
+
+    // strong exception guarantee - items are not modified if allocation fails
+    void reserve(size_t capacity)
+    {
+        if (capacity <= capacity_)
+            return;
+
+        int* data = get_allocator().allocate(capacity);
+
+        copy_items(data_, size_, data);
+        release();
+        data_ = data;
+        capacity_ = capacity;
+    }
+
+    void append(const int* items, size_t count)
+    {
+        copy_items(items, count, reserve_back(count));
+        size_ += count;
+    }
+
+    void append(std::initializer_list<int> items)
+    {
+        append(items.begin(), items.size());
+    }
+
+    // if copying of an item throws, items appended so far are discarded
+    template <typename InputIt, typename = RequireInputIterator<InputIt>>
+    void append(InputIt first, InputIt last)
+    {
+        if constexpr (std::is_convertible_v<IteratorCategory<InputIt>, std::forward_iterator_tag>)
+        {
+            const size_t count = static_cast<size_t>(std::distance(first, last));
+
+            copy_items(first, last, reserve_back(count));
+            size_ += count;
+        }
+        else
+        {
+            const size_t size = size_;
+
+            try
+            {
+                for (; first != last; ++first)
+                {
+                    *reserve_back(1) = *first;
+                    ++size_;
+                }
+            }
+            catch (...)
+            {
+                size_ = size;
+                throw;
+            }
+        }
+    }
+
+    template <typename TRange, typename = RequireRange<TRange>>
+    void append(const TRange& items)
+    {
+        if constexpr (IsContiguousRangeOfInts<TRange>::value)
+            append(std::data(items), static_cast<size_t>(std::size(items)));
+        else
+            append(std::begin(items), std::end(items));
+    }
+
+    // generator is called with indexes 0..count-1 of appended items or once with the whole block
+    template <typename TGenerator, typename = RequireGenerator<TGenerator>>
+    void append(size_t count, TGenerator generator)
+    {
+        int* dest = reserve_back(count);
+
+        if constexpr (is_block_generator_v<TGenerator>)
+            generator(dest, count);
+        else
+        {
+            for (size_t i = 0; i < count; ++i)
+                dest[i] = generator(i);
+        }
+
+        size_ += count;
+    }
+
+    allocator_type get_allocator() const noexcept
+    {
+        return allocator_type {resource_};
+    }
+
+    const std::string& name() const noexcept
+    {
+        return name_;
+    }
+
+    bool is_inline() const noexcept
+    {
+        return capacity_ <= InlineCapacity;
+    }
+
+    size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    size_t capacity() const noexcept
+    {
+        return capacity_;
+    }
+
+    iterator begin()
+    {
+        return data_;
+    }
+
+    iterator end()
+    {
+        return data_ + size_;
+    }
+
+    const_iterator begin() const
+    {
+        return data_;
+    }
+
+    const_iterator end() const
+    {
+        return data_ + size_;
+    }
+};
+
+using DataSet = BasicDataSet<8>;
+
+#endif // DATA_SET_HPP
@@ -0,0 +1,281 @@
+#include "data_set_file.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace DataSetFile;
+
+namespace
+{
+    // returns offset of items - throws std::runtime_error if header does not describe a valid file
+    size_t validate(const FileHeader& header, uint64_t file_size, const std::string& path)
+    {
+        if (std::memcmp(header.magic, DataSetFile::magic, sizeof(header.magic)) != 0)
+            throw std::runtime_error("not a DataSet file: " + path);
+
+        if (header.version != DataSetFile::version)
+            throw std::runtime_error("unsupported version " + std::to_string(header.version) + " of DataSet file: " + path);
+
+        const uint64_t offset = data_offset(header.name_length);
+
+        if (file_size < offset || (file_size - offset) / sizeof(int) < header.count)
+            throw std::runtime_error("truncated DataSet file: " + path);
+
+        return offset;
+    }
+
+    // iostreams do not report the cause of a failure (errno is not guaranteed to be set)
+    std::system_error stream_error(const std::string& what)
+    {
+        return std::system_error(std::make_error_code(std::io_errc::stream), what);
+    }
+
+    // error of the last failed system call
+    std::system_error last_error(const std::string& what)
+    {
+#ifdef _WIN32
+        return std::system_error(static_cast<int>(GetLastError()), std::system_category(), what);
+#else
+        return std::system_error(errno, std::generic_category(), what);
+#endif
+    }
+}
+
+uint64_t DataSetFile::checksum(const int* items, size_t count) noexcept
+{
+    constexpr uint64_t modulus = 0xFFFFFFFF;
+    constexpr size_t block_size = 64 * 1024; // sums cannot overflow before reduction
+
+    uint64_t sum1 = 0;
+    uint64_t sum2 = 0;
+
+    for (size_t begin = 0; begin < count; begin += block_size)
+    {
+        const size_t end = std::min(count, begin + block_size);
+
+        for (size_t i = begin; i < end; ++i)
+        {
+            sum1 += static_cast<uint32_t>(items[i]);
+            sum2 += sum1;
+        }
+
+        sum1 %= modulus;
+        sum2 %= modulus;
+    }
+
+    return (sum2 << 32) | sum1;
+}
+
+void DataSetFile::write(const std::string& path, const std::string& name, const int* items, size_t count)
+{
+    FileHeader header {};
+    std::memcpy(header.magic, DataSetFile::magic, sizeof(header.magic));
+    header.version = DataSetFile::version;
+    header.name_length = static_cast<uint32_t>(name.size());
+    header.count = count;
+    header.checksum = checksum(items, count);
+
+    const char padding[8] = {};
+    const size_t padding_size = data_offset(name.size()) - sizeof(FileHeader) - name.size();
+
+    std::ofstream out {path, std::ios::binary | std::ios::trunc};
+    if (!out)
+        throw stream_error("cannot open " + path);
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(name.data(), name.size());
+    out.write(padding, padding_size);
+    out.write(reinterpret_cast<const char*>(items), count * sizeof(int));
+    out.flush();
+
+    if (!out)
+        throw stream_error("cannot write " + path);
+}
+
+DataSet DataSetFile::read(const std::string& path, const DataSet::allocator_type& alloc)
+{
+    std::ifstream in {path, std::ios::binary};
+    if (!in)
+        throw stream_error("cannot open " + path);
+
+    FileHeader header {};
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)))
+        throw std::runtime_error("truncated DataSet file: " + path);
+
+    const size_t offset = validate(header, std::filesystem::file_size(path), path);
+
+    std::string name(header.name_length, '\0');
+    in.read(name.data(), name.size());
+    in.seekg(offset);
+
+    // items are read directly into the storage of DataSet
+    DataSet ds {std::move(name), header.count, [&in](int* dest, size_t count) {
+                    in.read(reinterpret_cast<char*>(dest), count * sizeof(int));
+                },
+        alloc};
+
+    if (!in)
+        throw stream_error("cannot read " + path);
+
+    if (checksum(ds.begin(), ds.size()) != header.checksum)
+        throw std::runtime_error("checksum mismatch in DataSet file: " + path);
+
+    return ds;
+}
+
+MappedDataSet::MappedDataSet(const std::string& path)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        throw last_error("cannot open " + path);
+
+    LARGE_INTEGER file_size {};
+    if (!GetFileSizeEx(file, &file_size))
+    {
+        const auto error = last_error("cannot get size of " + path);
+        CloseHandle(file);
+        throw error;
+    }
+
+    // empty file cannot be mapped
+    if (file_size.QuadPart < static_cast<LONGLONG>(sizeof(FileHeader)))
+    {
+        CloseHandle(file);
+        throw std::runtime_error("truncated DataSet file: " + path);
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping)
+    {
+        mapping_ = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping); // view keeps the mapping alive
+    }
+
+    if (!mapping_)
+    {
+        const auto error = last_error("cannot map " + path);
+        CloseHandle(file);
+        throw error;
+    }
+
+    CloseHandle(file);
+
+    mapping_size_ = static_cast<size_t>(file_size.QuadPart);
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd == -1)
+        throw last_error("cannot open " + path);
+
+    struct stat file_stat {};
+    if (::fstat(fd, &file_stat) != 0)
+    {
+        const auto error = last_error("cannot get size of " + path);
+        ::close(fd);
+        throw error;
+    }
+
+    // empty file cannot be mapped
+    if (static_cast<size_t>(file_stat.st_size) < sizeof(FileHeader))
+    {
+        ::close(fd);
+        throw std::runtime_error("truncated DataSet file: " + path);
+    }
+
+    void* mapping = ::mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    const int error = errno;
+    ::close(fd); // mapping keeps the file open
+
+    if (mapping == MAP_FAILED)
+        throw std::system_error(error, std::generic_category(), "cannot map " + path);
+
+    mapping_ = mapping;
+    mapping_size_ = static_cast<size_t>(file_stat.st_size);
+#endif
+
+    try
+    {
+        if (mapping_size_ < sizeof(FileHeader))
+            throw std::runtime_error("truncated DataSet file: " + path);
+
+        const auto* header = static_cast<const FileHeader*>(mapping_);
+        const size_t offset = validate(*header, mapping_size_, path);
+        const char* bytes = static_cast<const char*>(mapping_);
+
+        name_.assign(bytes + sizeof(FileHeader), header->name_length);
+        data_ = reinterpret_cast<const int*>(bytes + offset);
+        size_ = header->count;
+        checksum_ = header->checksum;
+    }
+    catch (...)
+    {
+        unmap();
+        throw;
+    }
+}
+
+MappedDataSet::MappedDataSet(MappedDataSet&& other) noexcept
+    : mapping_ {std::exchange(other.mapping_, nullptr)}
+    , mapping_size_ {std::exchange(other.mapping_size_, 0)}
+    , name_ {std::move(other.name_)}
+    , data_ {std::exchange(other.data_, nullptr)}
+    , size_ {std::exchange(other.size_, 0)}
+    , checksum_ {std::exchange(other.checksum_, 0)}
+{
+}
+
+MappedDataSet& MappedDataSet::operator=(MappedDataSet&& other) noexcept
+{
+    if (this != &other)
+    {
+        unmap();
+
+        mapping_ = std::exchange(other.mapping_, nullptr);
+        mapping_size_ = std::exchange(other.mapping_size_, 0);
+        name_ = std::move(other.name_);
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        checksum_ = std::exchange(other.checksum_, 0);
+    }
+
+    return *this;
+}
+
+MappedDataSet::~MappedDataSet()
+{
+    unmap();
+}
+
+void MappedDataSet::unmap() noexcept
+{
+    if (!mapping_)
+        return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(mapping_);
+#else
+    ::munmap(const_cast<void*>(mapping_), mapping_size_);
+#endif
+
+    mapping_ = nullptr;
+}
+
+bool MappedDataSet::verify() const noexcept
+{
+    return DataSetFile::checksum(data_, size_) == checksum_;
+}
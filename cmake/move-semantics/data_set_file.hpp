@@ -0,0 +1,116 @@
+#ifndef DATA_SET_FILE_HPP
+#define DATA_SET_FILE_HPP
+
+#include "data_set.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+////////////////////////////////////////////////////////////////////////////
+// Binary files with DataSet
+//
+// Layout (native byte order):
+//   FileHeader | name (name_length chars) | padding to 8 bytes | items (count ints)
+//
+// DataSetFile::read() loads items into a heap-owning DataSet.
+// MappedDataSet maps the file read-only - items are paged in from disk on first access,
+// so opening takes the same time for 1 KB and 1 GB series, and pages can be shared by processes.
+//
+// Checksum is verified by read(). For MappedDataSet verification would touch all pages,
+// so it is done on demand with verify().
+
+namespace DataSetFile
+{
+    constexpr char magic[8] = {'D', 'A', 'T', 'A', 'S', 'E', 'T', '\0'};
+    constexpr uint32_t version = 1;
+
+    struct FileHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t name_length;
+        uint64_t count;
+        uint64_t checksum;
+    };
+
+    static_assert(sizeof(FileHeader) == 32);
+
+    // Fletcher-64 over 32-bit words
+    uint64_t checksum(const int* items, size_t count) noexcept;
+
+    // offset of items from the beginning of file - items are aligned to 8 bytes
+    constexpr size_t data_offset(size_t name_length) noexcept
+    {
+        return (sizeof(FileHeader) + name_length + 7) / 8 * 8;
+    }
+
+    // throws std::system_error if file cannot be written
+    void write(const std::string& path, const std::string& name, const int* items, size_t count);
+
+    template <size_t InlineCapacity>
+    void write(const std::string& path, const BasicDataSet<InlineCapacity>& ds)
+    {
+        write(path, ds.name(), ds.begin(), ds.size());
+    }
+
+    // throws std::system_error if file cannot be read, std::runtime_error if format or checksum is invalid
+    DataSet read(const std::string& path, const DataSet::allocator_type& alloc = {});
+}
+
+// read-only view of a DataSet file mapped into memory - move-only, moved-from object is empty
+class MappedDataSet
+{
+    const void* mapping_ {nullptr};
+    size_t mapping_size_ {0};
+    std::string name_;
+    const int* data_ {nullptr};
+    size_t size_ {0};
+    uint64_t checksum_ {0};
+
+    void unmap() noexcept;
+
+public:
+    using iterator = const int*;
+    using const_iterator = const int*;
+
+    // throws std::system_error if file cannot be mapped, std::runtime_error if format is invalid
+    explicit MappedDataSet(const std::string& path);
+
+    MappedDataSet(const MappedDataSet&) = delete;
+    MappedDataSet& operator=(const MappedDataSet&) = delete;
+
+    MappedDataSet(MappedDataSet&& other) noexcept;
+    MappedDataSet& operator=(MappedDataSet&& other) noexcept;
+
+    ~MappedDataSet();
+
+    const std::string& name() const noexcept
+    {
+        return name_;
+    }
+
+    size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return data_;
+    }
+
+    const_iterator end() const noexcept
+    {
+        return data_ + size();
+    }
+
+    uint64_t checksum() const noexcept
+    {
+        return checksum_;
+    }
+
+    // reads all items - true if checksum matches
+    bool verify() const noexcept;
+};
+
+#endif // DATA_SET_FILE_HPP
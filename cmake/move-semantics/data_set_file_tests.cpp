@@ -0,0 +1,254 @@
+#include "catch.hpp"
+#include "data_set.hpp"
+#include "data_set_file.hpp"
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace
+{
+    // file in temp directory removed at the end of the scope
+    class TempFile
+    {
+        fs::path path_;
+
+    public:
+        explicit TempFile(const std::string& name)
+            : path_ {fs::temp_directory_path() / ("data_set_file_tests_" + name + ".bin")}
+        {
+        }
+
+        TempFile(const TempFile&) = delete;
+        TempFile& operator=(const TempFile&) = delete;
+
+        ~TempFile()
+        {
+            std::error_code ec;
+            fs::remove(path_, ec);
+        }
+
+        std::string path() const
+        {
+            return path_.string();
+        }
+    };
+
+    void overwrite_byte(const std::string& path, std::streamoff offset)
+    {
+        std::fstream file {path, std::ios::binary | std::ios::in | std::ios::out};
+        file.seekp(offset);
+        file.put('\x7F');
+    }
+
+    template <typename TDataSet>
+    std::vector<int> items(const TDataSet& ds)
+    {
+        return std::vector<int>(ds.begin(), ds.end());
+    }
+}
+
+TEST_CASE("DataSet file - write & read")
+{
+    TempFile file {"write_read"};
+    const DataSet ds {"temperatures", {12, -3, 7, 21, 0, 5, 9, 14, 2, 8}};
+
+    DataSetFile::write(file.path(), ds);
+
+    SECTION("file layout")
+    {
+        REQUIRE(fs::file_size(file.path()) == DataSetFile::data_offset(12) + 10 * sizeof(int));
+        REQUIRE(DataSetFile::data_offset(12) % 8 == 0);
+    }
+
+    SECTION("read into heap-owning DataSet")
+    {
+        DataSet loaded = DataSetFile::read(file.path());
+
+        REQUIRE(loaded.name() == "temperatures");
+        REQUIRE(items(loaded) == items(ds));
+    }
+
+    SECTION("memory mapped")
+    {
+        MappedDataSet mapped {file.path()};
+
+        REQUIRE(mapped.name() == "temperatures");
+        REQUIRE(mapped.size() == 10);
+        REQUIRE(items(mapped) == items(ds));
+        REQUIRE(mapped.verify());
+    }
+}
+
+TEST_CASE("DataSet file - empty series")
+{
+    TempFile file {"empty"};
+
+    DataSetFile::write(file.path(), DataSet {""});
+
+    REQUIRE(DataSetFile::read(file.path()).size() == 0);
+
+    MappedDataSet mapped {file.path()};
+    REQUIRE(mapped.begin() == mapped.end());
+    REQUIRE(mapped.verify());
+}
+
+TEST_CASE("DataSet file - invalid files")
+{
+    TempFile file {"invalid"};
+    DataSetFile::write(file.path(), DataSet {"ds", {1, 2, 3, 4, 5}});
+
+    SECTION("missing file")
+    {
+        REQUIRE_THROWS_AS(DataSetFile::read(file.path() + ".missing"), std::system_error);
+        REQUIRE_THROWS_AS(MappedDataSet {file.path() + ".missing"}, std::system_error);
+    }
+
+    SECTION("bad magic")
+    {
+        overwrite_byte(file.path(), 0);
+
+        REQUIRE_THROWS_AS(DataSetFile::read(file.path()), std::runtime_error);
+        REQUIRE_THROWS_AS(MappedDataSet {file.path()}, std::runtime_error);
+    }
+
+    SECTION("unsupported version")
+    {
+        overwrite_byte(file.path(), offsetof(DataSetFile::FileHeader, version));
+
+        REQUIRE_THROWS_WITH(MappedDataSet {file.path()}, Catch::Contains("unsupported version"));
+    }
+
+    SECTION("empty file")
+    {
+        fs::resize_file(file.path(), 0);
+
+        REQUIRE_THROWS_WITH(DataSetFile::read(file.path()), Catch::Contains("truncated"));
+        REQUIRE_THROWS_WITH(MappedDataSet {file.path()}, Catch::Contains("truncated"));
+    }
+
+    SECTION("truncated file")
+    {
+        fs::resize_file(file.path(), fs::file_size(file.path()) - 1);
+
+        REQUIRE_THROWS_WITH(DataSetFile::read(file.path()), Catch::Contains("truncated"));
+        REQUIRE_THROWS_WITH(MappedDataSet {file.path()}, Catch::Contains("truncated"));
+    }
+
+    SECTION("corrupted items")
+    {
+        overwrite_byte(file.path(), DataSetFile::data_offset(2) + 1);
+
+        REQUIRE_THROWS_WITH(DataSetFile::read(file.path()), Catch::Contains("checksum"));
+
+        MappedDataSet mapped {file.path()}; // checksum is verified on demand
+        REQUIRE_FALSE(mapped.verify());
+    }
+}
+
+TEST_CASE("MappedDataSet - move")
+{
+    TempFile file {"move"};
+    DataSetFile::write(file.path(), DataSet {"ds", {1, 2, 3}});
+
+    MappedDataSet mapped {file.path()};
+    const int* data = mapped.begin();
+
+    MappedDataSet target = std::move(mapped);
+    REQUIRE(target.begin() == data);
+    REQUIRE(mapped.size() == 0);
+
+    mapped = std::move(target);
+    REQUIRE(items(mapped) == (std::vector<int> {1, 2, 3}));
+}
+
+TEST_CASE("DataSet file - checksum")
+{
+    const std::vector<int> items = {1, 2, 3};
+
+    REQUIRE(DataSetFile::checksum(items.data(), 0) == 0);
+    REQUIRE(DataSetFile::checksum(items.data(), 3) == ((10ULL << 32) | 6));
+
+    const std::vector<int> swapped = {2, 1, 3};
+    REQUIRE(DataSetFile::checksum(swapped.data(), 3) != DataSetFile::checksum(items.data(), 3));
+}
+
+namespace
+{
+    // resident set size of the process in bytes - 0 if unknown
+    size_t resident_memory()
+    {
+#ifdef __linux__
+        std::ifstream statm {"/proc/self/statm"};
+        size_t total_pages = 0, resident_pages = 0;
+        statm >> total_pages >> resident_pages;
+
+        return resident_pages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#else
+        return 0;
+#endif
+    }
+
+    std::string megabytes(size_t bytes)
+    {
+        return std::to_string(bytes / (1024 * 1024)) + " MB";
+    }
+}
+
+TEST_CASE("DataSet file - startup with 1 GB series", "[.][benchmark]")
+{
+    TempFile file {"benchmark"};
+
+    {
+        DataSet ds {"large", (1 << 30) / sizeof(int), [](size_t i) { return static_cast<int>(i); }};
+        DataSetFile::write(file.path(), ds);
+    }
+
+    {
+        const size_t rss_before = resident_memory();
+        MappedDataSet mapped {file.path()};
+        const size_t rss_opened = resident_memory();
+        volatile int64_t sum = std::accumulate(mapped.begin(), mapped.end(), int64_t {0});
+        const size_t rss_scanned = resident_memory();
+
+        std::cout << "MappedDataSet - RSS growth: after open = " << megabytes(rss_opened - rss_before)
+                  << ", after scan = " << megabytes(rss_scanned - rss_before) << " (shared, page cache)\n";
+        (void)sum;
+    }
+
+    {
+        const size_t rss_before = resident_memory();
+        DataSet loaded = DataSetFile::read(file.path());
+        const size_t rss_loaded = resident_memory();
+
+        std::cout << "DataSetFile::read - RSS growth: after load = " << megabytes(rss_loaded - rss_before) << "\n";
+    }
+
+    BENCHMARK("MappedDataSet - open & read first item")
+    {
+        MappedDataSet mapped {file.path()};
+        return *mapped.begin();
+    };
+
+    BENCHMARK("MappedDataSet - open & verify checksum")
+    {
+        MappedDataSet mapped {file.path()};
+        return mapped.verify();
+    };
+
+    BENCHMARK("DataSetFile::read - load into heap")
+    {
+        return DataSetFile::read(file.path()).size();
+    };
+}
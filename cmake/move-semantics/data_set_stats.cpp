@@ -0,0 +1,215 @@
+#include "data_set_stats.hpp"
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define DATA_SET_STATS_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// GCC & Clang compile intrinsics only in functions targeting proper instruction set,
+// MSVC accepts them everywhere
+#if defined(__GNUC__) || defined(__clang__)
+#define TARGET_SSE4 __attribute__((target("sse4.1")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_SSE4
+#define TARGET_AVX2
+#endif
+
+using namespace DataSetStats;
+
+namespace
+{
+    void accumulate_scalar(Statistics& stats, const int* items, size_t size) noexcept
+    {
+        int64_t sum = 0;
+        int min = stats.min;
+        int max = stats.max;
+
+        for (size_t i = 0; i < size; ++i)
+        {
+            sum += items[i];
+            min = std::min(min, items[i]);
+            max = std::max(max, items[i]);
+        }
+
+        stats.count += size;
+        stats.sum += sum;
+        stats.min = min;
+        stats.max = max;
+    }
+
+    Statistics calculate_scalar(const int* items, size_t size) noexcept
+    {
+        Statistics stats;
+        accumulate_scalar(stats, items, size);
+
+        return stats;
+    }
+
+#ifdef DATA_SET_STATS_X86
+    // partial results kept in vector lanes: 32-bit min & max, 64-bit sums
+    template <size_t IntLanes>
+    Statistics reduce_lanes(const int (&min)[IntLanes], const int (&max)[IntLanes], const int64_t (&sum)[IntLanes / 2], size_t count) noexcept
+    {
+        Statistics stats;
+        stats.count = count;
+        stats.min = *std::min_element(std::begin(min), std::end(min));
+        stats.max = *std::max_element(std::begin(max), std::end(max));
+
+        for (int64_t s : sum)
+            stats.sum += s;
+
+        return stats;
+    }
+
+    TARGET_SSE4 Statistics calculate_sse4(const int* items, size_t size) noexcept
+    {
+        __m128i vmin = _mm_set1_epi32(INT_MAX);
+        __m128i vmax = _mm_set1_epi32(INT_MIN);
+        __m128i vsum = _mm_setzero_si128(); // low & high halves are summed separately - shorter dependency chains
+        __m128i vsum_high = _mm_setzero_si128();
+
+        const size_t vector_size = size - size % 4;
+
+        for (size_t i = 0; i < vector_size; i += 4)
+        {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(items + i));
+
+            vmin = _mm_min_epi32(vmin, v);
+            vmax = _mm_max_epi32(vmax, v);
+            vsum = _mm_add_epi64(vsum, _mm_cvtepi32_epi64(v));
+            vsum_high = _mm_add_epi64(vsum_high, _mm_cvtepi32_epi64(_mm_srli_si128(v, 8)));
+        }
+
+        int min[4], max[4];
+        int64_t sum[2];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(min), vmin);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(max), vmax);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(sum), _mm_add_epi64(vsum, vsum_high));
+
+        Statistics stats = reduce_lanes(min, max, sum, vector_size);
+        accumulate_scalar(stats, items + vector_size, size - vector_size);
+
+        return stats;
+    }
+
+    TARGET_AVX2 Statistics calculate_avx2(const int* items, size_t size) noexcept
+    {
+        __m256i vmin = _mm256_set1_epi32(INT_MAX);
+        __m256i vmax = _mm256_set1_epi32(INT_MIN);
+        __m256i vsum = _mm256_setzero_si256(); // low & high halves are summed separately - shorter dependency chains
+        __m256i vsum_high = _mm256_setzero_si256();
+
+        const size_t vector_size = size - size % 8;
+
+        for (size_t i = 0; i < vector_size; i += 8)
+        {
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(items + i));
+
+            vmin = _mm256_min_epi32(vmin, v);
+            vmax = _mm256_max_epi32(vmax, v);
+            vsum = _mm256_add_epi64(vsum, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)));
+            vsum_high = _mm256_add_epi64(vsum_high, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+        }
+
+        int min[8], max[8];
+        int64_t sum[4];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(min), vmin);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(max), vmax);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(sum), _mm256_add_epi64(vsum, vsum_high));
+
+        Statistics stats = reduce_lanes(min, max, sum, vector_size);
+        accumulate_scalar(stats, items + vector_size, size - vector_size);
+
+        return stats;
+    }
+
+    Isa detect_isa() noexcept
+    {
+#ifdef _MSC_VER
+        int regs[4];
+
+        __cpuid(regs, 0);
+        const int max_leaf = regs[0];
+
+        __cpuid(regs, 1);
+        const bool sse4 = (regs[2] & (1 << 19)) != 0;
+        const bool os_saves_ymm = (regs[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+
+        bool avx2 = false;
+        if (max_leaf >= 7 && os_saves_ymm)
+        {
+            __cpuidex(regs, 7, 0);
+            avx2 = (regs[1] & (1 << 5)) != 0;
+        }
+#else
+        __builtin_cpu_init();
+        const bool sse4 = __builtin_cpu_supports("sse4.1");
+        const bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+        if (avx2)
+            return Isa::avx2;
+        if (sse4)
+            return Isa::sse4;
+
+        return Isa::scalar;
+    }
+#else
+    Isa detect_isa() noexcept
+    {
+        return Isa::scalar;
+    }
+#endif
+}
+
+bool DataSetStats::is_supported(Isa isa) noexcept
+{
+    return isa <= best_isa();
+}
+
+Isa DataSetStats::best_isa() noexcept
+{
+    static const Isa isa = detect_isa();
+
+    return isa;
+}
+
+Statistics DataSetStats::calculate(const int* items, size_t size, Isa isa) noexcept
+{
+    switch (isa)
+    {
+#ifdef DATA_SET_STATS_X86
+    case Isa::avx2:
+        return calculate_avx2(items, size);
+    case Isa::sse4:
+        return calculate_sse4(items, size);
+#endif
+    default:
+        return calculate_scalar(items, size);
+    }
+}
+
+Statistics DataSetStats::calculate(const int* items, size_t size) noexcept
+{
+    using Kernel = Statistics (*)(const int*, size_t) noexcept;
+
+    static const Kernel kernel = []() -> Kernel {
+        switch (best_isa())
+        {
+#ifdef DATA_SET_STATS_X86
+        case Isa::avx2:
+            return &calculate_avx2;
+        case Isa::sse4:
+            return &calculate_sse4;
+#endif
+        default:
+            return &calculate_scalar;
+        }
+    }();
+
+    return kernel(items, size);
+}
@@ -0,0 +1,66 @@
+#ifndef DATA_SET_STATS_HPP
+#define DATA_SET_STATS_HPP
+
+#include "data_set.hpp"
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+
+////////////////////////////////////////////////////////////////////////////
+// Statistics of DataSet - sum, min, max & mean calculated in a single pass
+//
+// On x86 vectorized kernels (SSE4.1, AVX2) are selected at runtime with CPUID,
+// so binary built for a baseline CPU uses the widest instructions available.
+// Other platforms use the scalar kernel. Sum is accumulated in 64 bits - no overflow.
+
+namespace DataSetStats
+{
+    enum class Isa
+    {
+        scalar,
+        sse4,
+        avx2
+    };
+
+    struct Statistics
+    {
+        size_t count = 0;
+        int64_t sum = 0;
+        int min = INT_MAX; // INT_MAX & INT_MIN for an empty series
+        int max = INT_MIN;
+
+        double mean() const noexcept
+        {
+            return count ? static_cast<double>(sum) / count : 0.0;
+        }
+    };
+
+    inline bool operator==(const Statistics& a, const Statistics& b) noexcept
+    {
+        return a.count == b.count && a.sum == b.sum && a.min == b.min && a.max == b.max;
+    }
+
+    inline bool operator!=(const Statistics& a, const Statistics& b) noexcept
+    {
+        return !(a == b);
+    }
+
+    bool is_supported(Isa isa) noexcept;
+
+    // widest instruction set supported by CPU - detected once
+    Isa best_isa() noexcept;
+
+    // isa must be supported
+    Statistics calculate(const int* items, size_t size, Isa isa) noexcept;
+
+    // uses best_isa()
+    Statistics calculate(const int* items, size_t size) noexcept;
+}
+
+template <size_t InlineCapacity>
+DataSetStats::Statistics calculate_stats(const BasicDataSet<InlineCapacity>& ds) noexcept
+{
+    return DataSetStats::calculate(ds.begin(), ds.size());
+}
+
+#endif // DATA_SET_STATS_HPP
@@ -0,0 +1,154 @@
+#include "catch.hpp"
+#include "data_set.hpp"
+#include "data_set_stats.hpp"
+#include <algorithm>
+#include <climits>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace DataSetStats;
+
+namespace
+{
+    std::vector<Isa> supported_isas()
+    {
+        std::vector<Isa> isas;
+
+        for (Isa isa : {Isa::scalar, Isa::sse4, Isa::avx2})
+            if (is_supported(isa))
+                isas.push_back(isa);
+
+        return isas;
+    }
+
+    std::string to_string(Isa isa)
+    {
+        switch (isa)
+        {
+        case Isa::avx2:
+            return "avx2";
+        case Isa::sse4:
+            return "sse4";
+        default:
+            return "scalar";
+        }
+    }
+
+    Statistics reference_stats(const std::vector<int>& items)
+    {
+        Statistics stats;
+        stats.count = items.size();
+        stats.sum = std::accumulate(items.begin(), items.end(), int64_t {0});
+
+        if (!items.empty())
+        {
+            auto [min_pos, max_pos] = std::minmax_element(items.begin(), items.end());
+            stats.min = *min_pos;
+            stats.max = *max_pos;
+        }
+
+        return stats;
+    }
+}
+
+TEST_CASE("DataSet statistics")
+{
+    DataSet ds {"ds", {4, -2, 7, 1, 0, 3, 9, -5, 6, 2, 8}};
+
+    Statistics stats = calculate_stats(ds);
+
+    REQUIRE(stats.count == 11);
+    REQUIRE(stats.sum == 33);
+    REQUIRE(stats.min == -5);
+    REQUIRE(stats.max == 9);
+    REQUIRE(stats.mean() == Approx(3.0));
+}
+
+TEST_CASE("DataSet statistics - empty series")
+{
+    Statistics stats = calculate_stats(DataSet {"empty"});
+
+    REQUIRE(stats.count == 0);
+    REQUIRE(stats.sum == 0);
+    REQUIRE(stats.mean() == 0.0);
+}
+
+TEST_CASE("DataSet statistics - every kernel gives the same results")
+{
+    std::mt19937 rnd {42};
+    std::uniform_int_distribution<int> distr {INT_MIN, INT_MAX};
+
+    for (Isa isa : supported_isas())
+    {
+        INFO("isa: " << to_string(isa));
+
+        for (size_t size : {1, 3, 4, 7, 8, 9, 15, 16, 17, 31, 33, 100, 1001})
+        {
+            INFO("size: " << size);
+
+            std::vector<int> items(size);
+            std::generate(items.begin(), items.end(), [&] { return distr(rnd); });
+
+            REQUIRE(calculate(items.data(), items.size(), isa) == reference_stats(items));
+        }
+    }
+}
+
+TEST_CASE("DataSet statistics - sum does not overflow")
+{
+    const std::vector<int> items(1000, INT_MAX);
+
+    for (Isa isa : supported_isas())
+    {
+        INFO("isa: " << to_string(isa));
+
+        Statistics stats = calculate(items.data(), items.size(), isa);
+
+        REQUIRE(stats.sum == 1000LL * INT_MAX);
+        REQUIRE(stats.min == INT_MAX);
+        REQUIRE(stats.max == INT_MAX);
+    }
+}
+
+TEST_CASE("DataSet statistics - extreme values in the tail")
+{
+    std::vector<int> items(19, 0);
+    items.back() = INT_MIN;
+    items[items.size() - 2] = INT_MAX;
+
+    for (Isa isa : supported_isas())
+    {
+        Statistics stats = calculate(items.data(), items.size(), isa);
+
+        REQUIRE(stats.min == INT_MIN);
+        REQUIRE(stats.max == INT_MAX);
+    }
+}
+
+TEST_CASE("DataSet statistics - best isa", "[.][benchmark]")
+{
+    for (size_t size : {16, 1'000, 100'000, 10'000'000, 100'000'000})
+    {
+        DataSet ds {"ds", size, [](size_t i) { return static_cast<int>(i * 7919 % 100'003) - 50'000; }};
+        const std::string description = " - " + std::to_string(size) + " items";
+
+        BENCHMARK("std::accumulate + std::minmax_element" + description)
+        {
+            auto [min_pos, max_pos] = std::minmax_element(ds.begin(), ds.end());
+            int64_t sum = std::accumulate(ds.begin(), ds.end(), int64_t {0});
+
+            return sum + *min_pos + *max_pos;
+        };
+
+        for (Isa isa : supported_isas())
+        {
+            BENCHMARK(to_string(isa) + description)
+            {
+                return calculate(ds.begin(), ds.size(), isa).sum;
+            };
+        }
+    }
+}
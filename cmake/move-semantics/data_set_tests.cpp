@@ -0,0 +1,705 @@
+#include "allocation_counter.hpp"
+#include "catch.hpp"
+#include "counting_resource.hpp"
+#include "cow_data_set.hpp"
+#include "data_set.hpp"
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <list>
+#include <memory_resource>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace
+{
+    template <typename TDataSet>
+    std::vector<int> items(const TDataSet& ds)
+    {
+        return std::vector<int>(ds.begin(), ds.end());
+    }
+}
+
+TEST_CASE("DataSet - small buffer")
+{
+    BasicDataSet<4> small {"small", {1, 2, 3}};
+    BasicDataSet<4> large {"large", {1, 2, 3, 4, 5, 6}};
+
+    REQUIRE(small.is_inline());
+    REQUIRE_FALSE(large.is_inline());
+
+    SECTION("short series are not allocated on the heap")
+    {
+        AllocationCounter::Scope allocs;
+
+        BasicDataSet<4> ds {"ds", {1, 2, 3, 4}};
+        BasicDataSet<4> copy = ds;
+
+        REQUIRE(allocs.count() == 0);
+        REQUIRE(items(copy) == (std::vector<int> {1, 2, 3, 4}));
+    }
+
+    SECTION("copy of large series allocates once")
+    {
+        AllocationCounter::Scope allocs;
+
+        BasicDataSet<4> copy = large;
+
+        REQUIRE(allocs.count() == 1);
+        REQUIRE(items(copy) == items(large));
+        REQUIRE(copy.begin() != large.begin());
+    }
+
+    SECTION("move of inline series copies items into target buffer")
+    {
+        BasicDataSet<4> target = std::move(small);
+
+        REQUIRE(target.is_inline());
+        REQUIRE(items(target) == (std::vector<int> {1, 2, 3}));
+        REQUIRE(small.size() == 0);
+        REQUIRE(small.begin() == small.end());
+    }
+
+    SECTION("move of heap series steals buffer")
+    {
+        const int* buffer = large.begin();
+
+        AllocationCounter::Scope allocs;
+        BasicDataSet<4> target = std::move(large);
+
+        REQUIRE(allocs.count() == 0);
+        REQUIRE(target.begin() == buffer);
+        REQUIRE(large.size() == 0);
+    }
+
+    SECTION("move assignment across inline/heap boundary")
+    {
+        BasicDataSet<4> target {"target", {7, 8, 9, 10, 11}};
+
+        target = std::move(small);
+        REQUIRE(target.is_inline());
+        REQUIRE(items(target) == (std::vector<int> {1, 2, 3}));
+
+        target = std::move(large);
+        REQUIRE_FALSE(target.is_inline());
+        REQUIRE(items(target) == (std::vector<int> {1, 2, 3, 4, 5, 6}));
+    }
+
+    SECTION("copy assignment across inline/heap boundary")
+    {
+        BasicDataSet<4> target = small;
+
+        target = large;
+        REQUIRE(items(target) == items(large));
+
+        target = small;
+        REQUIRE(target.is_inline());
+        REQUIRE(items(target) == items(small));
+    }
+
+    SECTION("swap of inline and heap series")
+    {
+        small.swap(large);
+
+        REQUIRE_FALSE(small.is_inline());
+        REQUIRE(items(small) == (std::vector<int> {1, 2, 3, 4, 5, 6}));
+        REQUIRE(large.is_inline());
+        REQUIRE(items(large) == (std::vector<int> {1, 2, 3}));
+    }
+
+    SECTION("zero capacity - always on the heap")
+    {
+        AllocationCounter::Scope allocs;
+
+        BasicDataSet<0> ds {"ds", {1}};
+
+        REQUIRE(allocs.count() == 1);
+        REQUIRE_FALSE(ds.is_inline());
+    }
+}
+
+TEST_CASE("DataSet - vector of inline series")
+{
+    std::vector<DataSet> datasets;
+    datasets.reserve(100);
+
+    AllocationCounter::Scope allocs;
+
+    for (int i = 0; i < 100; ++i)
+        datasets.push_back(DataSet {"ds", {i, i + 1, i + 2}});
+
+    REQUIRE(allocs.count() == 0);
+    REQUIRE(items(datasets.back()) == (std::vector<int> {99, 100, 101}));
+}
+
+TEST_CASE("DataSet - memory resource")
+{
+    CountingResource resource;
+    const DataSet::allocator_type alloc {&resource};
+
+    SECTION("items are allocated from given resource")
+    {
+        {
+            DataSet ds {"ds", {1, 2, 3, 4, 5, 6, 7, 8, 9, 10}, alloc};
+
+            REQUIRE(ds.get_allocator() == alloc);
+            REQUIRE(resource.allocations() == 1);
+            REQUIRE(resource.bytes_in_use() == 10 * sizeof(int));
+        }
+
+        REQUIRE(resource.deallocations() == 1);
+        REQUIRE(resource.bytes_in_use() == 0);
+    }
+
+    SECTION("global operator new is not used")
+    {
+        std::array<std::byte, 1024> buffer;
+        std::pmr::monotonic_buffer_resource arena {buffer.data(), buffer.size(), std::pmr::null_memory_resource()};
+
+        AllocationCounter::Scope allocs;
+
+        DataSet ds {"ds", {1, 2, 3, 4, 5, 6, 7, 8, 9, 10}, &arena};
+        DataSet copy {ds, &arena};
+
+        REQUIRE(allocs.count() == 0);
+    }
+
+    SECTION("inline series do not touch resource")
+    {
+        DataSet ds {"ds", {1, 2, 3}, alloc};
+
+        REQUIRE(resource.allocations() == 0);
+    }
+
+    DataSet ds {"ds", {1, 2, 3, 4, 5, 6, 7, 8, 9, 10}, alloc};
+
+    SECTION("copy constructor uses default resource")
+    {
+        DataSet copy = ds;
+
+        REQUIRE(copy.get_allocator().resource() == std::pmr::get_default_resource());
+        REQUIRE(resource.allocations() == 1);
+    }
+
+    SECTION("allocator-extended copy constructor")
+    {
+        DataSet copy {ds, alloc};
+
+        REQUIRE(copy.get_allocator() == alloc);
+        REQUIRE(resource.allocations() == 2);
+        REQUIRE(items(copy) == items(ds));
+    }
+
+    SECTION("move constructor propagates resource")
+    {
+        DataSet target = std::move(ds);
+
+        REQUIRE(target.get_allocator() == alloc);
+        REQUIRE(resource.allocations() == 1);
+    }
+
+    SECTION("allocator-extended move constructor with other resource copies items")
+    {
+        CountingResource other_resource;
+        DataSet target {std::move(ds), &other_resource};
+
+        REQUIRE(other_resource.allocations() == 1);
+        REQUIRE(items(target) == (std::vector<int> {1, 2, 3, 4, 5, 6, 7, 8, 9, 10}));
+    }
+
+    SECTION("assignments keep resource of target")
+    {
+        CountingResource other_resource;
+        DataSet target {"target", {}, &other_resource};
+
+        target = ds;
+        REQUIRE(target.get_allocator().resource() == &other_resource);
+        REQUIRE(other_resource.allocations() == 1);
+
+        target = std::move(ds);
+        REQUIRE(target.get_allocator().resource() == &other_resource);
+        REQUIRE(other_resource.allocations() == 2);
+        REQUIRE(other_resource.deallocations() == 1);
+        REQUIRE(items(target) == (std::vector<int> {1, 2, 3, 4, 5, 6, 7, 8, 9, 10}));
+    }
+
+    SECTION("move assignment with equal resources steals buffer")
+    {
+        DataSet target {"target", {}, alloc};
+
+        target = std::move(ds);
+
+        REQUIRE(resource.allocations() == 1);
+        REQUIRE(ds.size() == 0);
+    }
+
+    SECTION("pmr::vector passes its resource to items")
+    {
+        std::pmr::vector<DataSet> datasets {&resource};
+        datasets.reserve(2);
+
+        datasets.push_back(ds);
+        datasets.emplace_back("ds2", std::initializer_list<int> {1, 2, 3, 4, 5, 6, 7, 8, 9});
+
+        REQUIRE(datasets[0].get_allocator() == alloc);
+        REQUIRE(datasets[1].get_allocator() == alloc);
+        REQUIRE(resource.allocations() == 4); // ds + vector + 2 items
+    }
+}
+
+TEST_CASE("DataSet - monotonic arena per request")
+{
+    CountingResource upstream;
+
+    {
+        std::pmr::monotonic_buffer_resource arena {128 * 1024, &upstream};
+
+        for (int i = 0; i < 1000; ++i)
+        {
+            DataSet ds {"ds", {i, i, i, i, i, i, i, i, i, i, i, i}, &arena};
+            DataSet copy {ds, &arena};
+        }
+
+        REQUIRE(upstream.allocations() == 1);
+    }
+
+    REQUIRE(upstream.deallocations() == 1);
+}
+
+TEST_CASE("DataSet - bulk construction")
+{
+    const std::vector<int> source = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+
+    SECTION("contiguous block - one exact allocation")
+    {
+        AllocationCounter::Scope allocs;
+
+        DataSet ds {"ds", source.data(), source.size()};
+
+        REQUIRE(allocs.count() == 1);
+        REQUIRE(ds.capacity() == source.size());
+        REQUIRE(items(ds) == source);
+    }
+
+    SECTION("contiguous range")
+    {
+        const std::array<int, 4> arr = {1, 2, 3, 4};
+
+        DataSet small {"small", arr};
+        DataSet large {"large", source};
+
+        REQUIRE(small.is_inline());
+        REQUIRE(items(small) == (std::vector<int> {1, 2, 3, 4}));
+        REQUIRE(items(large) == source);
+    }
+
+    SECTION("forward iterators - size is known up front")
+    {
+        const std::list<int> lst(source.begin(), source.end());
+
+        AllocationCounter::Scope allocs;
+
+        DataSet ds {"ds", lst.begin(), lst.end()};
+
+        REQUIRE(allocs.count() == 1);
+        REQUIRE(items(ds) == source);
+    }
+
+    SECTION("range of other type")
+    {
+        const std::vector<short> shorts = {1, 2, 3};
+
+        DataSet ds {"ds", shorts};
+
+        REQUIRE(items(ds) == (std::vector<int> {1, 2, 3}));
+    }
+
+    SECTION("input iterators - storage grows")
+    {
+        std::istringstream in {"1 2 3 4 5 6 7 8 9 10 11 12"};
+
+        DataSet ds {"ds", std::istream_iterator<int> {in}, std::istream_iterator<int> {}};
+
+        REQUIRE(items(ds) == source);
+        REQUIRE(ds.capacity() >= ds.size());
+    }
+
+    SECTION("generator of items")
+    {
+        AllocationCounter::Scope allocs;
+
+        DataSet ds {"ds", 12, [](size_t i) { return static_cast<int>(i + 1); }};
+
+        REQUIRE(allocs.count() == 1);
+        REQUIRE(items(ds) == source);
+    }
+
+    SECTION("generator filling a block")
+    {
+        DataSet ds {"ds", 12, [&source](int* dest, size_t count) {
+                        std::copy_n(source.begin(), count, dest);
+                    }};
+
+        REQUIRE(items(ds) == source);
+    }
+
+    SECTION("memory resource")
+    {
+        CountingResource resource;
+
+        DataSet ds {"ds", source, &resource};
+
+        REQUIRE(resource.allocations() == 1);
+        REQUIRE(resource.bytes_in_use() == source.size() * sizeof(int));
+    }
+}
+
+TEST_CASE("DataSet - append")
+{
+    DataSet ds {"ds", {1, 2, 3}};
+
+    SECTION("within inline capacity")
+    {
+        AllocationCounter::Scope allocs;
+
+        ds.append({4, 5, 6, 7, 8});
+
+        REQUIRE(allocs.count() == 0);
+        REQUIRE(ds.is_inline());
+        REQUIRE(items(ds) == (std::vector<int> {1, 2, 3, 4, 5, 6, 7, 8}));
+    }
+
+    SECTION("moves items to the heap")
+    {
+        const int block[] = {4, 5, 6, 7, 8, 9, 10};
+
+        ds.append(block, 7);
+
+        REQUIRE_FALSE(ds.is_inline());
+        REQUIRE(items(ds) == (std::vector<int> {1, 2, 3, 4, 5, 6, 7, 8, 9, 10}));
+    }
+
+    SECTION("chunks - storage grows geometrically")
+    {
+        AllocationCounter::Scope allocs;
+
+        for (int i = 0; i < 1000; ++i)
+            ds.append(1, [i](size_t) { return i; });
+
+        REQUIRE(ds.size() == 1003);
+        REQUIRE(allocs.count() < 10);
+        REQUIRE(ds.begin()[1002] == 999);
+    }
+
+    SECTION("reserve")
+    {
+        ds.reserve(100);
+        const int* buffer = ds.begin();
+
+        AllocationCounter::Scope allocs;
+        ds.append(std::vector<int>(97, 1));
+
+        REQUIRE(allocs.count() == 1); // temporary vector only
+        REQUIRE(ds.begin() == buffer);
+        REQUIRE(ds.size() == 100);
+    }
+
+    SECTION("appended series is copied & moved with its capacity")
+    {
+        ds.append(std::vector<int>(20, 1));
+
+        DataSet copy = ds;
+        REQUIRE(copy.capacity() == ds.size());
+
+        DataSet target = std::move(ds);
+        REQUIRE(target.size() == 23);
+        REQUIRE(ds.is_inline());
+        REQUIRE(ds.capacity() == DataSet::inline_capacity);
+    }
+
+    SECTION("copy assignment from reserved series with few items")
+    {
+        DataSet source {"source"};
+        source.reserve(100);
+        source.append({1, 2});
+
+        DataSet target {"target", {7}};
+        target = source;
+
+        REQUIRE(target.is_inline());
+        REQUIRE(target.capacity() == DataSet::inline_capacity);
+
+        DataSet other {"other", std::vector<int>(20, 3)};
+        target.swap(other);
+
+        REQUIRE(items(other) == (std::vector<int> {1, 2}));
+        REQUIRE(items(target) == std::vector<int>(20, 3));
+    }
+}
+
+namespace
+{
+    template <typename TDataSet>
+    void benchmark_copy_and_move(const std::string& description, const TDataSet& ds)
+    {
+        constexpr size_t no_of_ops = 1000;
+        size_t copy_allocations {};
+        size_t move_allocations {};
+
+        for (size_t i = 0; i < no_of_ops; ++i)
+        {
+            AllocationCounter::Scope copy_allocs;
+            TDataSet copy = ds;
+            copy_allocations += copy_allocs.count();
+
+            AllocationCounter::Scope move_allocs;
+            TDataSet target = std::move(copy);
+            move_allocations += move_allocs.count();
+        }
+
+        std::cout << description << " - allocations per op: copy = "
+                  << static_cast<double>(copy_allocations) / no_of_ops
+                  << ", move = " << static_cast<double>(move_allocations) / no_of_ops << "\n";
+
+        BENCHMARK("copy - " + description)
+        {
+            return TDataSet {ds};
+        };
+
+        BENCHMARK_ADVANCED("move - " + description)(Catch::Benchmark::Chronometer meter)
+        {
+            std::vector<TDataSet> sources(meter.runs(), ds);
+            meter.measure([&sources](int i) { return TDataSet {std::move(sources[i])}; });
+        };
+    }
+}
+
+TEST_CASE("DataSet - copy & move", "[.][benchmark]")
+{
+    const BasicDataSet<8> inline_ds {"inline", {1, 2, 3, 4, 5, 6, 7}};
+    const BasicDataSet<0> heap_ds {"heap", {1, 2, 3, 4, 5, 6, 7}};
+    const BasicDataSet<8> large_ds {"large", {
+        1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16,
+        17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32,
+        33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48,
+        49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63, 64}};
+
+    benchmark_copy_and_move("7 items inline", inline_ds);
+    benchmark_copy_and_move("7 items on heap", heap_ds);
+    benchmark_copy_and_move("64 items on heap", large_ds);
+}
+
+TEST_CASE("DataSet - ingesting 10^7 items", "[.][benchmark]")
+{
+    constexpr size_t no_of_items = 10'000'000;
+    constexpr size_t chunk_size = 64 * 1024 / sizeof(int);
+
+    std::vector<int> source(no_of_items);
+    std::iota(source.begin(), source.end(), 0);
+
+    const std::list<int> lst(source.begin(), source.begin() + no_of_items / 10);
+
+    BENCHMARK("vector - temporary copy (before bulk API)")
+    {
+        std::vector<int> temp(source.begin(), source.end());
+        return temp.size();
+    };
+
+    BENCHMARK("pointer & size")
+    {
+        return DataSet {"ds", source.data(), source.size()}.size();
+    };
+
+    BENCHMARK("contiguous range")
+    {
+        return DataSet {"ds", source}.size();
+    };
+
+    BENCHMARK("random access iterators")
+    {
+        return DataSet {"ds", source.begin(), source.end()}.size();
+    };
+
+    BENCHMARK("std::list iterators - 10^6 items")
+    {
+        return DataSet {"ds", lst.begin(), lst.end()}.size();
+    };
+
+    BENCHMARK("generator of items")
+    {
+        return DataSet {"ds", no_of_items, [](size_t i) { return static_cast<int>(i); }}.size();
+    };
+
+    BENCHMARK("generator filling a block")
+    {
+        return DataSet {"ds", no_of_items, [&source](int* dest, size_t count) {
+                            std::memcpy(dest, source.data(), count * sizeof(int));
+                        }}.size();
+    };
+
+    BENCHMARK("append in 64KB chunks")
+    {
+        DataSet ds {"ds"};
+
+        for (size_t offset = 0; offset < no_of_items; offset += chunk_size)
+            ds.append(source.data() + offset, std::min(chunk_size, no_of_items - offset));
+
+        return ds.size();
+    };
+}
+
+TEST_CASE("CowDataSet - copy on write")
+{
+    CowDataSet ds {"ds", {1, 2, 3, 4, 5}};
+
+    SECTION("copies share buffer")
+    {
+        CowDataSet backup = ds;
+
+        REQUIRE(backup.is_shared());
+        REQUIRE(std::as_const(backup).begin() == std::as_const(ds).begin());
+        REQUIRE(backup.cbegin() == ds.cbegin());
+    }
+
+    SECTION("mutable access clones shared buffer")
+    {
+        CowDataSet backup = ds;
+
+        backup[0] = 42;
+
+        REQUIRE_FALSE(backup.is_shared());
+        REQUIRE_FALSE(ds.is_shared());
+        REQUIRE(items(ds) == (std::vector<int> {1, 2, 3, 4, 5}));
+        REQUIRE(items(backup) == (std::vector<int> {42, 2, 3, 4, 5}));
+    }
+
+    SECTION("mutable access to unique buffer does not clone")
+    {
+        const int* buffer = ds.cbegin();
+
+        *ds.begin() = 42;
+
+        REQUIRE(ds.cbegin() == buffer);
+    }
+
+    SECTION("buffer handed out for writing is not shared with later copies")
+    {
+        int& first = ds[0];
+
+        CowDataSet backup = ds;
+        first = 42;
+
+        REQUIRE(backup[0] == 1);
+        REQUIRE(backup.cbegin() != ds.cbegin());
+    }
+
+    SECTION("snapshot of DataSet")
+    {
+        DataSet source {"source", {1, 2, 3}};
+        CowDataSet snapshot {"snapshot", source};
+
+        REQUIRE(items(snapshot) == items(source));
+    }
+
+    SECTION("snapshot of ranges of ints only")
+    {
+        static_assert(std::is_constructible_v<CowDataSet, std::string, std::vector<int>>);
+        static_assert(std::is_constructible_v<CowDataSet, std::string, std::list<int>>);
+        static_assert(std::is_constructible_v<CowDataSet, std::string, int[3]>);
+        static_assert(!std::is_constructible_v<CowDataSet, std::string, std::string>);
+        static_assert(!std::is_constructible_v<CowDataSet, std::string, std::vector<double>>);
+        static_assert(!std::is_constructible_v<CowDataSet, std::string, int>);
+
+        const std::list<int> source = {1, 2, 3};
+        CowDataSet snapshot {"snapshot", source};
+
+        REQUIRE(items(snapshot) == std::vector<int>(source.begin(), source.end()));
+    }
+
+    SECTION("moved-from object")
+    {
+        CowDataSet target = std::move(ds);
+        CowDataSet copy = ds;
+
+        REQUIRE(ds.size() == 0);
+        REQUIRE(copy.size() == 0);
+        REQUIRE(ds.begin() == ds.end());
+    }
+}
+
+TEST_CASE("CowDataSet - copies used by many threads")
+{
+    const CowDataSet source {"source", {1, 2, 3, 4, 5}};
+
+    std::vector<std::thread> threads;
+    std::vector<int> sums(8);
+
+    for (size_t i = 0; i < sums.size(); ++i)
+        threads.emplace_back([source, &sum = sums[i], i]() mutable {
+            for (int n = 0; n < 1000; ++n)
+            {
+                CowDataSet local = source;
+                if (i % 2 == 0)
+                    local[0] = 0; // writers get private buffers
+                sum = std::accumulate(local.cbegin(), local.cend(), 0);
+            }
+        });
+
+    for (auto& t : threads)
+        t.join();
+
+    for (size_t i = 0; i < sums.size(); ++i)
+        REQUIRE(sums[i] == (i % 2 == 0 ? 14 : 15));
+
+    REQUIRE(items(source) == (std::vector<int> {1, 2, 3, 4, 5}));
+    REQUIRE_FALSE(source.is_shared());
+}
+
+namespace
+{
+    template <typename TDataSet, size_t... Is>
+    TDataSet make_data_set(std::index_sequence<Is...>)
+    {
+        return TDataSet {"large", {static_cast<int>(Is)...}};
+    }
+
+    template <typename TDataSet>
+    long long fan_out(const TDataSet& source, size_t no_of_readers)
+    {
+        long long result = 0;
+
+        for (size_t i = 0; i < no_of_readers; ++i)
+        {
+            const TDataSet reader_copy = source;
+            result += std::accumulate(reader_copy.begin(), reader_copy.end(), 0LL);
+        }
+
+        return result;
+    }
+}
+
+TEST_CASE("CowDataSet vs DataSet - fan-out to readers", "[.][benchmark]")
+{
+    constexpr size_t no_of_readers = 64;
+
+    auto eager_ds = make_data_set<DataSet>(std::make_index_sequence<4096>{});
+    auto cow_ds = make_data_set<CowDataSet>(std::make_index_sequence<4096>{});
+
+    BENCHMARK("DataSet - eager copy - 64 readers")
+    {
+        return fan_out(eager_ds, no_of_readers);
+    };
+
+    BENCHMARK("CowDataSet - 64 readers")
+    {
+        return fan_out(cow_ds, no_of_readers);
+    };
+}
@@ -0,0 +1,33 @@
+#ifndef GADGET_HPP
+#define GADGET_HPP
+
+#include "instrumentation.hpp"
+#include <iostream>
+#include <string>
+
+// calls of constructors, assignments & destructor are counted by Instrumented<Gadget>
+struct Gadget : Instrumented<Gadget>
+{
+    int value {};
+    std::string name {};
+
+    Gadget() = default;
+
+    Gadget(int v)
+        : value {v}
+    {
+    }
+
+    Gadget(int v, const std::string& n)
+        : value {v}
+        , name {n}
+    {
+    }
+
+    void use() const
+    {
+        std::cout << "Using Gadget(" << value << ")\n";
+    }
+};
+
+#endif // GADGET_HPP
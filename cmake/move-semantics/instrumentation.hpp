@@ -0,0 +1,112 @@
+#ifndef INSTRUMENTATION_HPP
+#define INSTRUMENTATION_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <initializer_list>
+
+////////////////////////////////////////////////////////////////////////////
+// Instrumented<T> - base class counting calls of special members of T
+//
+// With ENABLE_INSTRUMENTATION defined every type has its own set of atomic counters.
+// Otherwise Instrumented<T> is an empty class with trivial special members - no cost.
+//
+// Types with user provided copy/move operations have to call the base class explicitly.
+
+struct LifetimeCounters
+{
+    std::atomic<size_t> constructions {0}; // default & other non copy/move constructors
+    std::atomic<size_t> copy_constructions {0};
+    std::atomic<size_t> move_constructions {0};
+    std::atomic<size_t> copy_assignments {0};
+    std::atomic<size_t> move_assignments {0};
+    std::atomic<size_t> destructions {0};
+
+    size_t copies() const noexcept
+    {
+        return copy_constructions + copy_assignments;
+    }
+
+    size_t moves() const noexcept
+    {
+        return move_constructions + move_assignments;
+    }
+
+    size_t alive() const noexcept
+    {
+        return constructions + copy_constructions + move_constructions - destructions;
+    }
+
+    void reset() noexcept
+    {
+        for (auto* counter : {&constructions, &copy_constructions, &move_constructions,
+                 &copy_assignments, &move_assignments, &destructions})
+            counter->store(0);
+    }
+};
+
+#ifdef ENABLE_INSTRUMENTATION
+
+template <typename T>
+class Instrumented
+{
+    static void count(std::atomic<size_t>& counter) noexcept
+    {
+        counter.fetch_add(1, std::memory_order_relaxed);
+    }
+
+public:
+    static constexpr bool enabled = true;
+
+    static LifetimeCounters& counters() noexcept
+    {
+        static LifetimeCounters counters;
+        return counters;
+    }
+
+protected:
+    Instrumented() noexcept
+    {
+        count(counters().constructions);
+    }
+
+    Instrumented(const Instrumented&) noexcept
+    {
+        count(counters().copy_constructions);
+    }
+
+    Instrumented(Instrumented&&) noexcept
+    {
+        count(counters().move_constructions);
+    }
+
+    Instrumented& operator=(const Instrumented&) noexcept
+    {
+        count(counters().copy_assignments);
+        return *this;
+    }
+
+    Instrumented& operator=(Instrumented&&) noexcept
+    {
+        count(counters().move_assignments);
+        return *this;
+    }
+
+    ~Instrumented()
+    {
+        count(counters().destructions);
+    }
+};
+
+#else
+
+template <typename T>
+class Instrumented
+{
+public:
+    static constexpr bool enabled = false;
+};
+
+#endif
+
+#endif // INSTRUMENTATION_HPP
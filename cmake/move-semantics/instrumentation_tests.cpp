@@ -0,0 +1,116 @@
+#include "catch.hpp"
+#include "data_set.hpp"
+#include "gadget.hpp"
+#include "mpmc_queue.hpp"
+#include <vector>
+
+#ifdef ENABLE_INSTRUMENTATION
+
+using namespace std;
+
+namespace
+{
+    // move constructor may throw - vector has to copy items when it grows
+    struct ThrowingMove : Instrumented<ThrowingMove>
+    {
+        ThrowingMove() = default;
+        ThrowingMove(const ThrowingMove&) = default;
+        ThrowingMove(ThrowingMove&& other) noexcept(false) = default;
+    };
+}
+
+TEST_CASE("Instrumentation - DataSet")
+{
+    LifetimeCounters& counters = DataSet::counters();
+    counters.reset();
+
+    {
+        DataSet ds1 {"ds1", {1, 2, 3}};
+        DataSet ds2 {"ds2", {1, 2, 3, 4, 5, 6, 7, 8, 9, 10}};
+
+        DataSet backup = ds1; // copy
+        DataSet target = std::move(ds2); // move
+
+        backup = target; // copy assignment
+        target = DataSet {"temp", {1}}; // move assignment
+
+        REQUIRE(counters.constructions == 3);
+        REQUIRE(counters.copy_constructions == 1);
+        REQUIRE(counters.move_constructions == 1);
+        REQUIRE(counters.copy_assignments == 1);
+        REQUIRE(counters.move_assignments == 1);
+        REQUIRE(counters.alive() == 4);
+    }
+
+    REQUIRE(counters.alive() == 0);
+}
+
+TEST_CASE("Instrumentation - counters are per type")
+{
+    DataSet::counters().reset();
+    BasicDataSet<0>::counters().reset();
+
+    BasicDataSet<0> ds {"ds", {1, 2, 3}};
+    BasicDataSet<0> copy = ds;
+
+    REQUIRE(BasicDataSet<0>::counters().copies() == 1);
+    REQUIRE(DataSet::counters().copies() == 0);
+}
+
+TEST_CASE("Instrumentation - vector<DataSet> moves items because move constructor is noexcept")
+{
+    static_assert(std::is_nothrow_move_constructible_v<DataSet>);
+
+    DataSet::counters().reset();
+
+    std::vector<DataSet> datasets;
+    for (int i = 0; i < 100; ++i)
+        datasets.push_back(DataSet {"ds", {i, i, i}});
+
+    REQUIRE(DataSet::counters().copies() == 0);
+    REQUIRE(DataSet::counters().move_constructions >= 100);
+}
+
+TEST_CASE("Instrumentation - vector copies items if move constructor may throw")
+{
+    ThrowingMove::counters().reset();
+
+    std::vector<ThrowingMove> items(1);
+    items.emplace_back();
+
+    REQUIRE(ThrowingMove::counters().copy_constructions == 1);
+}
+
+TEST_CASE("Instrumentation - Gadget")
+{
+    LifetimeCounters& counters = Gadget::counters();
+    counters.reset();
+
+    SECTION("rule of zero - defaulted special members are counted")
+    {
+        Gadget g {1, "ipad"};
+        Gadget copy = g;
+        Gadget target = std::move(g);
+
+        REQUIRE(counters.constructions == 1);
+        REQUIRE(counters.copies() == 1);
+        REQUIRE(counters.moves() == 1);
+    }
+
+    SECTION("MpmcQueue moves gadgets")
+    {
+        MpmcQueue<Gadget> q {4};
+
+        q.push(Gadget {1, "ipad"});
+        q.emplace(2, "smartwatch");
+        Gadget g1 = q.pop();
+        Gadget g2 = q.pop();
+
+        REQUIRE(counters.copies() == 0);
+        REQUIRE(counters.constructions == 2);
+    }
+
+    REQUIRE(counters.alive() == 0);
+}
+
+#endif
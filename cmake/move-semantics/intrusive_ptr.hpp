@@ -0,0 +1,249 @@
+#ifndef INTRUSIVE_PTR_HPP
+#define INTRUSIVE_PTR_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+////////////////////////////////////////////////
+// IntrusivePtr - shared ownership with reference counter stored in the object
+//
+// Pointer has size of T*, object & counter are allocated together and there is no control block.
+// Counting policy decides whether counter is atomic (objects shared between threads) or not.
+
+// counter for objects shared between threads
+class AtomicCounter
+{
+    std::atomic<size_t> count_ {0};
+
+public:
+    void increment() noexcept
+    {
+        count_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // returns true if it was the last reference
+    bool decrement() noexcept
+    {
+        if (count_.fetch_sub(1, std::memory_order_release) == 1)
+        {
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return true;
+        }
+
+        return false;
+    }
+
+    // acquire - if value is 1, changes made by previous owners are visible to the caller
+    size_t value() const noexcept
+    {
+        return count_.load(std::memory_order_acquire);
+    }
+};
+
+// counter for objects used by a single thread
+class NonAtomicCounter
+{
+    size_t count_ {0};
+
+public:
+    void increment() noexcept
+    {
+        ++count_;
+    }
+
+    bool decrement() noexcept
+    {
+        return --count_ == 0;
+    }
+
+    size_t value() const noexcept
+    {
+        return count_;
+    }
+};
+
+// base class for objects owned by IntrusivePtr (CRTP - object is deleted as TDerived)
+template <typename TDerived, typename TCounter = AtomicCounter>
+class RefCounted
+{
+    mutable TCounter ref_count_;
+
+    friend void intrusive_add_ref(const RefCounted* ptr) noexcept
+    {
+        ptr->ref_count_.increment();
+    }
+
+    friend void intrusive_release(const RefCounted* ptr) noexcept
+    {
+        if (ptr->ref_count_.decrement())
+            delete static_cast<const TDerived*>(ptr);
+    }
+
+protected:
+    RefCounted() = default;
+
+    // copy of an object is a new object - counter is not copied
+    RefCounted(const RefCounted&) noexcept
+    {
+    }
+
+    RefCounted& operator=(const RefCounted&) noexcept
+    {
+        return *this;
+    }
+
+    ~RefCounted() = default;
+
+public:
+    using counter_type = TCounter;
+
+    size_t use_count() const noexcept
+    {
+        return ref_count_.value();
+    }
+};
+
+// adds reference counter to existing type, e.g. RefCountedObject<DataSet>
+template <typename T, typename TCounter = AtomicCounter>
+class RefCountedObject : public T, public RefCounted<RefCountedObject<T, TCounter>, TCounter>
+{
+public:
+    using T::T;
+
+    RefCountedObject(const T& value)
+        : T(value)
+    {
+    }
+
+    RefCountedObject(T&& value)
+        : T(std::move(value))
+    {
+    }
+};
+
+template <typename T>
+class IntrusivePtr
+{
+    T* ptr_;
+
+public:
+    using element_type = T;
+
+    IntrusivePtr() noexcept
+        : ptr_ {nullptr}
+    {
+    }
+
+    IntrusivePtr(std::nullptr_t) noexcept
+        : ptr_ {nullptr}
+    {
+    }
+
+    explicit IntrusivePtr(T* ptr) noexcept
+        : ptr_ {ptr}
+    {
+        if (ptr_)
+            intrusive_add_ref(ptr_);
+    }
+
+    IntrusivePtr(const IntrusivePtr& other) noexcept
+        : IntrusivePtr(other.ptr_)
+    {
+    }
+
+    IntrusivePtr(IntrusivePtr&& other) noexcept
+        : ptr_ {std::exchange(other.ptr_, nullptr)}
+    {
+    }
+
+    IntrusivePtr& operator=(const IntrusivePtr& other) noexcept
+    {
+        IntrusivePtr temp(other);
+        swap(temp);
+
+        return *this;
+    }
+
+    IntrusivePtr& operator=(IntrusivePtr&& other) noexcept
+    {
+        IntrusivePtr temp(std::move(other));
+        swap(temp);
+
+        return *this;
+    }
+
+    ~IntrusivePtr()
+    {
+        if (ptr_)
+            intrusive_release(ptr_);
+    }
+
+    void swap(IntrusivePtr& other) noexcept
+    {
+        std::swap(ptr_, other.ptr_);
+    }
+
+    void reset() noexcept
+    {
+        IntrusivePtr().swap(*this);
+    }
+
+    T* get() const noexcept
+    {
+        return ptr_;
+    }
+
+    T* operator->() const noexcept
+    {
+        return ptr_;
+    }
+
+    T& operator*() const noexcept
+    {
+        return *ptr_;
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return ptr_ != nullptr;
+    }
+
+    size_t use_count() const noexcept
+    {
+        return ptr_ ? ptr_->use_count() : 0;
+    }
+};
+
+template <typename T>
+bool operator==(const IntrusivePtr<T>& a, const IntrusivePtr<T>& b) noexcept
+{
+    return a.get() == b.get();
+}
+
+template <typename T>
+bool operator!=(const IntrusivePtr<T>& a, const IntrusivePtr<T>& b) noexcept
+{
+    return a.get() != b.get();
+}
+
+template <typename T>
+bool operator==(const IntrusivePtr<T>& ptr, std::nullptr_t) noexcept
+{
+    return !ptr;
+}
+
+template <typename T>
+bool operator!=(const IntrusivePtr<T>& ptr, std::nullptr_t) noexcept
+{
+    return static_cast<bool>(ptr);
+}
+
+// single allocation - counter is a part of the object
+template <typename T, typename... TArgs>
+IntrusivePtr<T> MakeIntrusive(TArgs&&... args)
+{
+    return IntrusivePtr<T> {new T(std::forward<TArgs>(args)...)};
+}
+
+#endif // INTRUSIVE_PTR_HPP
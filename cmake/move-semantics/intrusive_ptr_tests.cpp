@@ -0,0 +1,255 @@
+#include "allocation_counter.hpp"
+#include "catch.hpp"
+#include "data_set.hpp"
+#include "intrusive_ptr.hpp"
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace
+{
+    class Node : public RefCounted<Node>
+    {
+        std::string name_;
+        int* destroyed_;
+
+    public:
+        Node(std::string name, int* destroyed)
+            : name_ {std::move(name)}
+            , destroyed_ {destroyed}
+        {
+        }
+
+        ~Node()
+        {
+            ++*destroyed_;
+        }
+
+        const std::string& name() const
+        {
+            return name_;
+        }
+    };
+
+    struct LocalNode : RefCounted<LocalNode, NonAtomicCounter>
+    {
+        int value;
+
+        explicit LocalNode(int v)
+            : value {v}
+        {
+        }
+    };
+
+    using SharedDataSet = RefCountedObject<DataSet>;
+}
+
+static_assert(sizeof(IntrusivePtr<Node>) == sizeof(Node*));
+static_assert(sizeof(IntrusivePtr<Node>) < sizeof(std::shared_ptr<Node>));
+
+TEST_CASE("IntrusivePtr - shared ownership")
+{
+    int destroyed = 0;
+
+    {
+        IntrusivePtr<Node> ptr1 = MakeIntrusive<Node>("node", &destroyed);
+        REQUIRE(ptr1.use_count() == 1);
+
+        {
+            IntrusivePtr<Node> ptr2 = ptr1; // copy
+            REQUIRE(ptr1.use_count() == 2);
+            REQUIRE(ptr2 == ptr1);
+
+            IntrusivePtr<Node> ptr3 = std::move(ptr2); // move - counter is not touched
+            REQUIRE(ptr1.use_count() == 2);
+            REQUIRE(ptr2 == nullptr);
+        }
+
+        REQUIRE(ptr1.use_count() == 1);
+        REQUIRE(destroyed == 0);
+        REQUIRE(ptr1->name() == "node");
+    }
+
+    REQUIRE(destroyed == 1);
+}
+
+TEST_CASE("IntrusivePtr - assignment & reset")
+{
+    int destroyed = 0;
+
+    IntrusivePtr<Node> ptr1 = MakeIntrusive<Node>("a", &destroyed);
+    IntrusivePtr<Node> ptr2 = MakeIntrusive<Node>("b", &destroyed);
+
+    ptr2 = ptr1;
+    REQUIRE(destroyed == 1);
+    REQUIRE(ptr1.use_count() == 2);
+
+    ptr2 = ptr2; // self-assignment
+    REQUIRE(ptr1.use_count() == 2);
+
+    ptr1.reset();
+    REQUIRE(ptr1 == nullptr);
+    REQUIRE(ptr2.use_count() == 1);
+
+    ptr2 = IntrusivePtr<Node> {};
+    REQUIRE(destroyed == 2);
+}
+
+TEST_CASE("IntrusivePtr - raw pointer can be adopted again")
+{
+    int destroyed = 0;
+
+    IntrusivePtr<Node> ptr1 = MakeIntrusive<Node>("node", &destroyed);
+    Node* raw = ptr1.get();
+
+    IntrusivePtr<Node> ptr2 {raw}; // counter lives in object - no double delete
+
+    REQUIRE(ptr1.use_count() == 2);
+}
+
+TEST_CASE("IntrusivePtr - non-atomic counter")
+{
+    IntrusivePtr<LocalNode> ptr = MakeIntrusive<LocalNode>(42);
+    IntrusivePtr<LocalNode> copy = ptr;
+
+    REQUIRE(copy.use_count() == 2);
+    REQUIRE(copy->value == 42);
+}
+
+TEST_CASE("IntrusivePtr - shared DataSet")
+{
+    SECTION("one allocation for object & counter")
+    {
+        AllocationCounter::Scope allocs;
+
+        IntrusivePtr<SharedDataSet> ds = MakeIntrusive<SharedDataSet>("ds", std::initializer_list<int> {1, 2, 3});
+
+        REQUIRE(allocs.count() == 1);
+        REQUIRE(ds->size() == 3);
+    }
+
+    SECTION("existing DataSet can be moved into shared one")
+    {
+        DataSet ds {"ds", {1, 2, 3, 4, 5, 6, 7, 8, 9, 10}};
+        const int* buffer = ds.begin();
+
+        IntrusivePtr<SharedDataSet> shared_ds = MakeIntrusive<SharedDataSet>(std::move(ds));
+        IntrusivePtr<SharedDataSet> other_stage = shared_ds;
+
+        REQUIRE(other_stage->begin() == buffer);
+    }
+
+    SECTION("copy of object has its own counter")
+    {
+        IntrusivePtr<SharedDataSet> ds = MakeIntrusive<SharedDataSet>("ds", std::initializer_list<int> {1, 2, 3});
+        IntrusivePtr<SharedDataSet> copy = MakeIntrusive<SharedDataSet>(*ds);
+
+        REQUIRE(ds.use_count() == 1);
+        REQUIRE(copy.use_count() == 1);
+    }
+}
+
+TEST_CASE("IntrusivePtr - shared between threads")
+{
+    int destroyed = 0;
+    IntrusivePtr<Node> ptr = MakeIntrusive<Node>("node", &destroyed);
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i)
+        threads.emplace_back([ptr] {
+            for (int i = 0; i < 10'000; ++i)
+            {
+                IntrusivePtr<Node> copy = ptr;
+            }
+        });
+
+    for (auto& t : threads)
+        t.join();
+
+    REQUIRE(ptr.use_count() == 1);
+    REQUIRE(destroyed == 0);
+}
+
+namespace
+{
+    struct Payload
+    {
+        int value {};
+    };
+
+    struct AtomicPayload : RefCounted<AtomicPayload>
+    {
+        int value {};
+    };
+
+    struct NonAtomicPayload : RefCounted<NonAtomicPayload, NonAtomicCounter>
+    {
+        int value {};
+    };
+
+    template <typename TPtr>
+    size_t copy_and_destroy(const TPtr& ptr, int no_of_copies)
+    {
+        size_t result = 0;
+
+        for (int i = 0; i < no_of_copies; ++i)
+        {
+            TPtr copy = ptr;
+            result += copy.use_count();
+        }
+
+        return result;
+    }
+
+    template <typename TPtr>
+    void copy_and_destroy_in_threads(const TPtr& ptr, int no_of_threads, int no_of_copies)
+    {
+        std::vector<std::thread> threads;
+
+        for (int i = 0; i < no_of_threads; ++i)
+            threads.emplace_back([&ptr, no_of_copies] { copy_and_destroy(ptr, no_of_copies); });
+
+        for (auto& t : threads)
+            t.join();
+    }
+}
+
+TEST_CASE("IntrusivePtr vs shared_ptr - copy & destroy", "[.][benchmark]")
+{
+    auto shared = std::make_shared<Payload>();
+    auto intrusive = MakeIntrusive<AtomicPayload>();
+    auto local_intrusive = MakeIntrusive<NonAtomicPayload>();
+
+    constexpr int no_of_copies = 1'000;
+
+    BENCHMARK("shared_ptr - 1 thread")
+    {
+        return copy_and_destroy(shared, no_of_copies);
+    };
+
+    BENCHMARK("IntrusivePtr<AtomicCounter> - 1 thread")
+    {
+        return copy_and_destroy(intrusive, no_of_copies);
+    };
+
+    BENCHMARK("IntrusivePtr<NonAtomicCounter> - 1 thread")
+    {
+        return copy_and_destroy(local_intrusive, no_of_copies);
+    };
+
+    const int no_of_threads = std::max(2, static_cast<int>(std::thread::hardware_concurrency()));
+    const std::string threads_desc = std::to_string(no_of_threads) + " threads";
+
+    BENCHMARK("shared_ptr - " + threads_desc)
+    {
+        copy_and_destroy_in_threads(shared, no_of_threads, 100 * no_of_copies);
+    };
+
+    BENCHMARK("IntrusivePtr<AtomicCounter> - " + threads_desc)
+    {
+        copy_and_destroy_in_threads(intrusive, no_of_threads, 100 * no_of_copies);
+    };
+}
@@ -1,7 +1,12 @@
 #include "catch.hpp"
+#include "counting_resource.hpp"
+#include "data_set.hpp"
+#include "gadget.hpp"
+#include "unique_ptr.hpp"
 #include <deque>
 #include <iostream>
 #include <map>
+#include <memory_resource>
 #include <string>
 #include <vector>
 
@@ -69,105 +74,6 @@ TEST_CASE("using push_back")
 }
 
 
-////////////////////////////////////////////////
-// simplified implementation of unique_ptr - only moveable type
-
-template <typename T>
-class UniquePtr
-{
-    T* ptr_;
-
-public:
-    UniquePtr(nullptr_t)
-        : ptr_ {nullptr}
-    {
-    }
-
-    UniquePtr(const UniquePtr&) = delete;
-    UniquePtr& operator=(const UniquePtr&) = delete;
-
-    UniquePtr(UniquePtr&& other) // move constructor
-        : ptr_ {other.ptr_}
-    {
-        other.ptr_ = nullptr;
-    }
-
-    UniquePtr& operator=(UniquePtr&& other) // move assignment
-    {
-        if (this != &other)
-        {
-            delete ptr_; // release previous state
-
-            // transfer state from other to this
-            ptr_ = other.ptr_;
-            other.ptr_ = nullptr;
-        }
-
-        return *this;
-    }
-
-    ~UniquePtr()
-    {
-        delete ptr_;
-    }
-
-    explicit UniquePtr(T* ptr)
-        : ptr_ {ptr}
-    {
-    }
-
-    explicit operator bool() const
-    {
-        return ptr_ != nullptr;
-    }
-
-    T* get() const
-    {
-        return ptr_;
-    }
-
-    T* operator->() const
-    {
-        return ptr_;
-    }
-
-    T& operator*() const
-    {
-        return ptr_;
-    }
-};
-
-struct Gadget
-{
-    int value {};
-    std::string name {};
-
-    Gadget() = default;
-
-    Gadget(int v)
-        : value {v}
-    {
-        cout << "Gadget(" << value << ")\n";
-    }
-
-    Gadget(int v, const std::string& n)
-        : value {v}
-        , name {n}
-    {
-        cout << "Gadget(" << value << ", " << name << ")\n";
-    }
-
-    void use() const
-    {
-        cout << "Using Gadget(" << value << ")\n";
-    }
-
-    ~Gadget()
-    {
-        cout << "~Gadget(" << value << ")\n";
-    }
-};
-
 UniquePtr<Gadget> create_gadget()
 {
     static int id_gen = 0;
@@ -182,12 +88,6 @@ void use_and_destroy(UniquePtr<Gadget> ptr)
     ptr->use();
 }
 
-template <typename T, typename... TArgs>
-UniquePtr<T> MakeUnique(TArgs&&... args)
-{
-    return UniquePtr<T>{new T(std::forward<TArgs>(args)...)};
-}
-
 TEST_CASE("move semantics - UniquePtr")
 {
     UniquePtr<Gadget> pg1 = MakeUnique<Gadget>(1, "ipad");
@@ -206,111 +106,6 @@ TEST_CASE("move semantics - UniquePtr")
     use_and_destroy(create_gadget());
 }
 
-////////////////////////////////////////////////////////////////////////////
-// DataSet - class with copy & move semantics (user provided implementation)
-
-class DataSet
-{
-    std::string name_;
-    int* data_;
-    size_t size_;
-
-public:
-    using iterator = int*;
-    using const_iterator = const int*;
-
-    DataSet(std::string name, std::initializer_list<int> list)
-        : name_ {std::move(name)}
-        , size_ {list.size()}
-    {
-        data_ = new int[list.size()];
-        std::copy(list.begin(), list.end(), data_);
-
-        std::cout << "DataSet(" << name_ << ")\n";
-    }
-
-    DataSet(const DataSet& other)
-        : name_(other.name_)
-        , size_(other.size_)
-    {
-        std::cout << "DataSet(" << name_ << ": cc)\n";
-        data_ = new int[size_];
-        std::copy(other.begin(), other.end(), data_);
-    }
-
-    void swap(DataSet& other)
-    {
-        name_.swap(other.name_);
-        std::swap(data_, other.data_);
-        std::swap(size_, other.size_);
-    }
-
-    DataSet& operator=(const DataSet& other)
-    {
-        DataSet temp(other);
-        swap(temp);
-
-        std::cout << "DataSet=(" << name_ << ": cc)\n";
-
-        return *this;
-    }
-
-    DataSet(DataSet&& other) noexcept
-        : name_ {std::move(other.name_)} // noexcept
-        , data_ {other.data_} // noexcept
-        , size_ {other.size_} // noexcept
-    {
-        other.size_ = 0; // noexcept
-        other.data_ = nullptr; // noexcept
-
-        std::cout << "DataSet(" << name_ << ": mv)\n";
-    }
-
-    DataSet& operator=(DataSet&& other)
-    {
-        if (this != &other)
-        {
-            delete[] data_;
-
-            name_ = std::move(other.name_);
-
-            size_ = other.size_;
-            other.size_ = 0;
-
-            data_ = other.data_;
-            other.data_ = nullptr;
-
-            std::cout << "DataSet=(" << name_ << ": mv)\n";
-        }
-        return *this;
-    }
-
-    ~DataSet()
-    {
-        delete[] data_;
-    }
-
-    iterator begin()
-    {
-        return data_;
-    }
-
-    iterator end()
-    {
-        return data_ + size_;
-    }
-
-    const_iterator begin() const
-    {
-        return data_;
-    }
-
-    const_iterator end() const
-    {
-        return data_ + size_;
-    }
-};
-
 DataSet create_data_set()
 {
     DataSet ds {"data-set-one", {54, 6, 34, 235, 64356, 235, 23}};
@@ -356,17 +151,38 @@ TEST_CASE("DataSet")
 
 namespace ValueSemanticsTake
 {
+    // allocator-aware - items are allocated from memory resource passed to constructor
+    // (copy & move semantics of pmr::vector are inherited by special members generated by compiler)
     class DataSet
     {
         std::string name_;
-        std::vector<int> data_;
+        std::pmr::vector<int> data_;
 
     public:
+        using allocator_type = std::pmr::polymorphic_allocator<int>;
+
         DataSet() = default;
 
-        DataSet(std::string name, std::initializer_list<int> list)
+        explicit DataSet(const allocator_type& alloc)
+            : data_ {alloc}
+        {
+        }
+
+        DataSet(std::string name, std::initializer_list<int> list, const allocator_type& alloc = {})
             : name_ {std::move(name)}
-            , data_ {list}
+            , data_ {list, alloc}
+        {
+        }
+
+        DataSet(const DataSet& other, const allocator_type& alloc)
+            : name_ {other.name_}
+            , data_ {other.data_, alloc}
+        {
+        }
+
+        DataSet(DataSet&& other, const allocator_type& alloc)
+            : name_ {std::move(other.name_)}
+            , data_ {std::move(other.data_), alloc}
         {
         }
 
@@ -378,13 +194,18 @@ namespace ValueSemanticsTake
 
         // ~DataSet() {}
 
+        allocator_type get_allocator() const
+        {
+            return data_.get_allocator();
+        }
+
         std::string name() const
         {
             return name_;
         }
 
-        using iterator = std::vector<int>::iterator;
-        using const_iterator = std::vector<int>::const_iterator;
+        using iterator = std::pmr::vector<int>::iterator;
+        using const_iterator = std::pmr::vector<int>::const_iterator;
 
         iterator begin()
         {
@@ -422,6 +243,58 @@ TEST_CASE("default copy & move")
     static_assert(std::is_move_constructible_v<UniquePtr<Gadget>>);
 }
 
+TEST_CASE("default copy & move - memory resource")
+{
+    CountingResource resource;
+    const ValueSemanticsTake::DataSet::allocator_type alloc {&resource};
+
+    ValueSemanticsTake::DataSet ds {"ds", {1, 2, 3, 4, 5}, alloc};
+    REQUIRE(resource.allocations() == 1);
+
+    SECTION("copy uses default resource")
+    {
+        ValueSemanticsTake::DataSet backup = ds;
+
+        REQUIRE(backup.get_allocator().resource() == std::pmr::get_default_resource());
+        REQUIRE(resource.allocations() == 1);
+    }
+
+    SECTION("move propagates resource")
+    {
+        ValueSemanticsTake::DataSet target = std::move(ds);
+
+        REQUIRE(target.get_allocator() == alloc);
+        REQUIRE(resource.allocations() == 1);
+    }
+
+    SECTION("assignment keeps resource of target")
+    {
+        ValueSemanticsTake::DataSet target {alloc};
+
+        target = ds;
+        target = ValueSemanticsTake::DataSet {"temp", {6, 7, 8, 9, 10, 11}};
+
+        REQUIRE(target.get_allocator() == alloc);
+        REQUIRE(resource.allocations() == 3);
+    }
+
+    SECTION("pmr containers use the same resource for all items")
+    {
+        std::pmr::monotonic_buffer_resource arena {4096, &resource};
+
+        std::pmr::vector<ValueSemanticsTake::DataSet> datasets {&arena};
+        datasets.reserve(3);
+        datasets.push_back(ds);
+        datasets.emplace_back("ds2", std::initializer_list<int> {1, 2, 3});
+        datasets.emplace_back();
+
+        for (const auto& item : datasets)
+            REQUIRE(item.get_allocator().resource() == &arena);
+
+        REQUIRE(resource.allocations() == 2); // ds + arena
+    }
+}
+
 template <typename T>
 class Queue
 {
@@ -562,7 +435,9 @@ TEST_CASE("auto&&")
 
 TEST_CASE("vector + noexcept")
 {
-    std::cout << "\n\n-------------------\n";
+#ifdef ENABLE_INSTRUMENTATION
+    DataSet::counters().reset();
+#endif
 
     std::vector<DataSet> datasets;
 
@@ -571,4 +446,10 @@ TEST_CASE("vector + noexcept")
     datasets.push_back(DataSet{"ds3", {1, 2, 3}});
     datasets.push_back(DataSet{"ds4", {1, 2, 3}});
     datasets.push_back(DataSet{"ds5", {1, 2, 3}});
+
+#ifdef ENABLE_INSTRUMENTATION
+    // move constructor is noexcept - vector moves items when it grows
+    REQUIRE(DataSet::counters().copies() == 0);
+    REQUIRE(DataSet::counters().move_constructions > 5);
+#endif
 }
\ No newline at end of file
@@ -0,0 +1,302 @@
+#ifndef MPMC_QUEUE_HPP
+#define MPMC_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+////////////////////////////////////////////////////////////////////////////
+// MpmcQueue - bounded multi-producer/multi-consumer FIFO queue
+//
+// Lock-free ring buffer (D. Vyukov's algorithm): each cell has a sequence number
+// that tells whether it is ready for the producer or the consumer of a given position.
+// Items are constructed in place in cells and moved out of them - they are never copied
+// unless push(const T&) is called.
+
+template <typename T>
+class MpmcQueue
+{
+    static_assert(std::is_nothrow_move_constructible_v<T>, "items are moved out of queue - move must be noexcept");
+    static_assert(std::is_nothrow_destructible_v<T>);
+
+    static constexpr size_t cache_line_size = 64;
+
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        std::aligned_storage_t<sizeof(T), alignof(T)> storage;
+
+        T* item() noexcept
+        {
+            return std::launder(reinterpret_cast<T*>(&storage));
+        }
+    };
+
+    std::unique_ptr<Cell[]> cells_;
+    size_t mask_;
+    alignas(cache_line_size) std::atomic<size_t> enqueue_pos_ {0};
+    alignas(cache_line_size) std::atomic<size_t> dequeue_pos_ {0};
+
+    static size_t round_up_to_power_of_2(size_t n)
+    {
+        size_t result = 2;
+        while (result < n)
+            result <<= 1;
+        return result;
+    }
+
+    // claimed cells must be published - batch of cells is claimed only if iterator cannot throw
+    // (std::move_iterator does not declare noexcept - its base iterator decides)
+    template <typename It>
+    struct IsNothrowIterator : std::bool_constant<noexcept(*std::declval<It&>()) && noexcept(++std::declval<It&>())>
+    {
+    };
+
+    template <typename It>
+    struct IsNothrowIterator<std::move_iterator<It>> : IsNothrowIterator<It>
+    {
+    };
+
+    static void backoff(unsigned& spins)
+    {
+        if (++spins < 64)
+            return;
+
+        std::this_thread::yield();
+    }
+
+    // claims up to max_count consecutive cells with sequence == pos + i + offset
+    // returns first claimed position and number of claimed cells
+    std::pair<size_t, size_t> claim(std::atomic<size_t>& position, size_t offset, size_t max_count)
+    {
+        size_t pos = position.load(std::memory_order_relaxed);
+
+        while (true)
+        {
+            size_t count = 0;
+            while (count < max_count
+                && cells_[(pos + count) & mask_].sequence.load(std::memory_order_acquire) == pos + count + offset)
+            {
+                ++count;
+            }
+
+            if (count == 0)
+            {
+                const size_t current = position.load(std::memory_order_relaxed);
+                if (current == pos)
+                    return {pos, 0}; // queue is full (producer) or empty (consumer)
+                pos = current;
+            }
+            else if (position.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed))
+                return {pos, count};
+        }
+    }
+
+    template <typename... TArgs>
+    void construct_at(size_t pos, TArgs&&... args)
+    {
+        // claimed cell must be published - construction cannot fail
+        static_assert(std::is_nothrow_constructible_v<T, TArgs&&...>);
+
+        Cell& cell = cells_[pos & mask_];
+        new (&cell.storage) T(std::forward<TArgs>(args)...);
+        cell.sequence.store(pos + 1, std::memory_order_release);
+    }
+
+    T extract_at(size_t pos) noexcept
+    {
+        Cell& cell = cells_[pos & mask_];
+
+        T item = std::move(*cell.item());
+        cell.item()->~T();
+
+        cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+
+        return item;
+    }
+
+public:
+    using value_type = T;
+
+    // capacity is rounded up to power of 2
+    explicit MpmcQueue(size_t capacity)
+        : cells_ {new Cell[round_up_to_power_of_2(capacity)]}
+        , mask_ {round_up_to_power_of_2(capacity) - 1}
+    {
+        for (size_t i = 0; i <= mask_; ++i)
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    ~MpmcQueue()
+    {
+        while (try_pop())
+            continue;
+    }
+
+    size_t capacity() const noexcept
+    {
+        return mask_ + 1;
+    }
+
+    // approximate if other threads use the queue
+    bool empty() const noexcept
+    {
+        return enqueue_pos_.load(std::memory_order_relaxed) == dequeue_pos_.load(std::memory_order_relaxed);
+    }
+
+    template <typename... TArgs>
+    bool try_emplace(TArgs&&... args)
+    {
+        if constexpr (!std::is_nothrow_constructible_v<T, TArgs&&...>)
+        {
+            // item is created before a cell is claimed - if construction throws queue is not affected
+            return try_emplace(T(std::forward<TArgs>(args)...));
+        }
+        else
+        {
+            auto [pos, count] = claim(enqueue_pos_, 0, 1);
+            if (count == 0)
+                return false;
+
+            construct_at(pos, std::forward<TArgs>(args)...);
+            return true;
+        }
+    }
+
+    bool try_push(const T& item)
+    {
+        return try_emplace(item);
+    }
+
+    bool try_push(T&& item)
+    {
+        return try_emplace(std::move(item));
+    }
+
+    // blocks while queue is full
+    template <typename... TArgs>
+    void emplace(TArgs&&... args)
+    {
+        if constexpr (!std::is_nothrow_constructible_v<T, TArgs&&...>)
+        {
+            emplace(T(std::forward<TArgs>(args)...));
+        }
+        else
+        {
+            for (unsigned spins = 0; !try_emplace(std::forward<TArgs>(args)...);)
+                backoff(spins);
+        }
+    }
+
+    void push(const T& item)
+    {
+        emplace(item);
+    }
+
+    void push(T&& item)
+    {
+        emplace(std::move(item));
+    }
+
+    // pushes count items starting from first; blocks while queue is full
+    // use std::make_move_iterator to move items into the queue
+    // items are pushed one by one if the iterator or construction of T may throw
+    template <typename InputIt>
+    InputIt push_n(InputIt first, size_t count)
+    {
+        if constexpr (!std::is_nothrow_constructible_v<T, decltype(*first)> || !IsNothrowIterator<InputIt>::value)
+        {
+            for (; count > 0; --count, ++first)
+                emplace(*first);
+        }
+        else
+        {
+            for (unsigned spins = 0; count > 0;)
+            {
+                auto [pos, claimed] = claim(enqueue_pos_, 0, count);
+
+                if (claimed == 0)
+                {
+                    backoff(spins);
+                    continue;
+                }
+
+                for (size_t i = 0; i < claimed; ++i, ++first)
+                    construct_at(pos + i, *first);
+
+                count -= claimed;
+                spins = 0;
+            }
+        }
+
+        return first;
+    }
+
+    std::optional<T> try_pop()
+    {
+        auto [pos, count] = claim(dequeue_pos_, 1, 1);
+        if (count == 0)
+            return std::nullopt;
+
+        return extract_at(pos);
+    }
+
+    // blocks while queue is empty
+    T pop()
+    {
+        for (unsigned spins = 0;; backoff(spins))
+        {
+            auto [pos, count] = claim(dequeue_pos_, 1, 1);
+            if (count != 0)
+                return extract_at(pos);
+        }
+    }
+
+    // blocks while queue is empty, then moves up to max_count items to out
+    // returns number of popped items
+    // if out throws, items popped by this call that are not written to out are destroyed
+    template <typename OutputIt>
+    size_t pop_n(OutputIt out, size_t max_count)
+    {
+        if (max_count == 0)
+            return 0;
+
+        for (unsigned spins = 0;; backoff(spins))
+        {
+            auto [pos, count] = claim(dequeue_pos_, 1, max_count);
+
+            if (count != 0)
+            {
+                size_t extracted = 0;
+                try
+                {
+                    for (; extracted < count; ++out)
+                    {
+                        T item = extract_at(pos + extracted++);
+                        *out = std::move(item);
+                    }
+                }
+                catch (...)
+                {
+                    // claimed cells are released - otherwise producers & consumers would wait for them forever
+                    for (; extracted < count; ++extracted)
+                        extract_at(pos + extracted);
+                    throw;
+                }
+
+                return count;
+            }
+        }
+    }
+};
+
+#endif // MPMC_QUEUE_HPP
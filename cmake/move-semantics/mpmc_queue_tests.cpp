@@ -0,0 +1,447 @@
+#include "catch.hpp"
+#include "data_set.hpp"
+#include "gadget.hpp"
+#include "mpmc_queue.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace
+{
+    // throws when limit of items is reached
+    struct LimitedOutput
+    {
+        using iterator_category = std::output_iterator_tag;
+        using value_type = void;
+        using difference_type = void;
+        using pointer = void;
+        using reference = void;
+
+        std::vector<int>* items;
+        size_t limit;
+
+        LimitedOutput& operator*()
+        {
+            return *this;
+        }
+
+        LimitedOutput& operator=(int item)
+        {
+            if (items->size() == limit)
+                throw std::length_error("output is full");
+
+            items->push_back(item);
+            return *this;
+        }
+
+        LimitedOutput& operator++()
+        {
+            return *this;
+        }
+    };
+
+    // dereference may throw - throws for negative items
+    struct ThrowingInput
+    {
+        using iterator_category = std::input_iterator_tag;
+        using value_type = int;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const int*;
+        using reference = const int&;
+
+        const int* item;
+
+        const int& operator*() const
+        {
+            if (*item < 0)
+                throw std::invalid_argument("negative item");
+
+            return *item;
+        }
+
+        ThrowingInput& operator++()
+        {
+            ++item;
+            return *this;
+        }
+    };
+}
+
+TEST_CASE("MpmcQueue - single thread")
+{
+    MpmcQueue<int> q {5};
+
+    REQUIRE(q.capacity() == 8);
+    REQUIRE(q.empty());
+
+    SECTION("items are popped in FIFO order")
+    {
+        q.push(1);
+        q.push(2);
+        q.emplace(3);
+
+        REQUIRE(q.pop() == 1);
+        REQUIRE(q.try_pop() == 2);
+        REQUIRE(q.try_pop() == 3);
+        REQUIRE(q.try_pop() == std::nullopt);
+    }
+
+    SECTION("try_push fails when queue is full")
+    {
+        for (int i = 0; i < 8; ++i)
+            REQUIRE(q.try_push(i));
+
+        REQUIRE_FALSE(q.try_push(8));
+
+        REQUIRE(q.pop() == 0);
+        REQUIRE(q.try_push(8));
+    }
+
+    SECTION("batch push & pop")
+    {
+        std::vector<int> input(6);
+        std::iota(input.begin(), input.end(), 1);
+
+        q.push_n(input.begin(), input.size());
+
+        std::vector<int> output;
+        REQUIRE(q.pop_n(std::back_inserter(output), 4) == 4);
+        REQUIRE(output == (std::vector<int> {1, 2, 3, 4}));
+
+        REQUIRE(q.pop_n(std::back_inserter(output), 4) == 2);
+        REQUIRE(output == input);
+    }
+
+    SECTION("pop_n releases claimed cells if output throws")
+    {
+        for (int i = 1; i <= 6; ++i)
+            q.push(i);
+
+        std::vector<int> output;
+        REQUIRE_THROWS_AS(q.pop_n(LimitedOutput {&output, 2}, 6), std::length_error);
+        REQUIRE(output == (std::vector<int> {1, 2}));
+        REQUIRE(q.empty());
+
+        // all cells are usable again
+        for (int i = 0; i < 8; ++i)
+            REQUIRE(q.try_push(i));
+        for (int i = 0; i < 8; ++i)
+            REQUIRE(q.pop() == i);
+    }
+
+    SECTION("push_n with iterator that may throw")
+    {
+        const int input[] = {1, 2, -1, 4};
+
+        REQUIRE_THROWS_AS(q.push_n(ThrowingInput {input}, 4), std::invalid_argument);
+
+        REQUIRE(q.pop() == 1);
+        REQUIRE(q.pop() == 2);
+        REQUIRE(q.try_pop() == std::nullopt);
+    }
+
+    SECTION("ring buffer wraps around")
+    {
+        for (int i = 0; i < 100; ++i)
+        {
+            q.push(i);
+            q.push(i + 1);
+            REQUIRE(q.pop() == i);
+            REQUIRE(q.pop() == i + 1);
+        }
+
+        REQUIRE(q.empty());
+    }
+}
+
+TEST_CASE("MpmcQueue - move semantics")
+{
+    SECTION("move-only items")
+    {
+        MpmcQueue<std::unique_ptr<int>> q {4};
+
+        q.push(std::make_unique<int>(1));
+        q.emplace(new int(2));
+
+        REQUIRE(*q.pop() == 1);
+        REQUIRE(*q.pop() == 2);
+    }
+
+    SECTION("DataSet is moved - not copied")
+    {
+        MpmcQueue<DataSet> q {4};
+
+        DataSet ds {"ds", {1, 2, 3, 4, 5, 6, 7, 8, 9, 10}};
+        const int* buffer = ds.begin();
+
+        q.push(std::move(ds));
+        DataSet result = q.pop();
+
+        REQUIRE(result.begin() == buffer);
+    }
+
+    SECTION("Gadget is moved - not copied")
+    {
+        MpmcQueue<Gadget> q {4};
+
+        Gadget g {1, "gadget with a name longer than small string buffer"};
+        const char* name = g.name.data();
+
+        q.push(std::move(g));
+        Gadget result = q.pop();
+
+        REQUIRE(result.name.data() == name);
+    }
+
+    SECTION("copy of lvalue")
+    {
+        MpmcQueue<DataSet> q {4};
+
+        DataSet ds {"ds", {1, 2, 3, 4, 5, 6, 7, 8, 9, 10}};
+        q.push(ds);
+
+        REQUIRE(q.pop().begin() != ds.begin());
+    }
+
+    SECTION("batch with move iterators")
+    {
+        MpmcQueue<std::unique_ptr<int>> q {4};
+
+        std::vector<std::unique_ptr<int>> items;
+        items.push_back(std::make_unique<int>(1));
+        items.push_back(std::make_unique<int>(2));
+
+        q.push_n(std::make_move_iterator(items.begin()), items.size());
+
+        std::vector<std::unique_ptr<int>> popped(2);
+        REQUIRE(q.pop_n(popped.begin(), 2) == 2);
+        REQUIRE(*popped[0] == 1);
+        REQUIRE(*popped[1] == 2);
+    }
+
+    SECTION("destructor destroys items left in queue")
+    {
+        auto item = std::make_shared<int>(42);
+
+        {
+            MpmcQueue<std::shared_ptr<int>> q {4};
+            q.push(item);
+            q.push(item);
+            REQUIRE(item.use_count() == 3);
+        }
+
+        REQUIRE(item.use_count() == 1);
+    }
+}
+
+namespace
+{
+    // producers push ranges of consecutive ids; returns ids popped by consumers
+    template <typename TQueue>
+    std::vector<int> produce_and_consume(TQueue& q, int no_of_producers, int no_of_consumers, int items_per_producer)
+    {
+        const int total = no_of_producers * items_per_producer;
+        std::atomic<int> items_left {total};
+        std::vector<std::vector<int>> consumed(no_of_consumers);
+
+        std::vector<std::thread> threads;
+
+        for (int p = 0; p < no_of_producers; ++p)
+            threads.emplace_back([&q, p, items_per_producer] {
+                for (int i = 0; i < items_per_producer; ++i)
+                    q.push(p * items_per_producer + i);
+            });
+
+        for (int c = 0; c < no_of_consumers; ++c)
+            threads.emplace_back([&q, &items_left, &result = consumed[c]] {
+                while (items_left.fetch_sub(1, std::memory_order_relaxed) > 0)
+                    result.push_back(q.pop());
+            });
+
+        for (auto& t : threads)
+            t.join();
+
+        std::vector<int> all;
+        for (const auto& items : consumed)
+        {
+            // items from one producer are seen by a consumer in order of pushing
+            for (int p = 0; p < no_of_producers; ++p)
+            {
+                std::vector<int> from_producer;
+                std::copy_if(items.begin(), items.end(), std::back_inserter(from_producer),
+                    [=](int id) { return id / items_per_producer == p; });
+                REQUIRE(std::is_sorted(from_producer.begin(), from_producer.end()));
+            }
+
+            all.insert(all.end(), items.begin(), items.end());
+        }
+
+        return all;
+    }
+}
+
+TEST_CASE("MpmcQueue - many producers & consumers")
+{
+    MpmcQueue<int> q {64};
+
+    const int no_of_producers = 4;
+    const int items_per_producer = 10'000;
+
+    std::vector<int> consumed = produce_and_consume(q, no_of_producers, 3, items_per_producer);
+
+    std::sort(consumed.begin(), consumed.end());
+    std::vector<int> expected(no_of_producers * items_per_producer);
+    std::iota(expected.begin(), expected.end(), 0);
+
+    REQUIRE(consumed == expected);
+    REQUIRE(q.empty());
+}
+
+TEST_CASE("MpmcQueue - batches from many threads")
+{
+    MpmcQueue<int> q {16};
+
+    const int no_of_producers = 4;
+    const int batches_per_producer = 1000;
+    const int batch_size = 10;
+    const int total = no_of_producers * batches_per_producer * batch_size;
+
+    std::atomic<int> items_left {total};
+    std::atomic<long long> sum {0};
+    std::vector<std::thread> threads;
+
+    for (int p = 0; p < no_of_producers; ++p)
+        threads.emplace_back([&q] {
+            std::vector<int> batch(batch_size, 1);
+            for (int i = 0; i < batches_per_producer; ++i)
+                q.push_n(batch.begin(), batch.size());
+        });
+
+    for (int c = 0; c < 2; ++c)
+        threads.emplace_back([&q, &items_left, &sum, batch_size] {
+            std::vector<int> batch(batch_size);
+
+            while (true)
+            {
+                // each consumer reserves number of items it is going to pop
+                int left = items_left.load();
+                int reserved;
+                do
+                {
+                    if (left <= 0)
+                        return;
+                    reserved = std::min(left, batch_size);
+                } while (!items_left.compare_exchange_weak(left, left - reserved));
+
+                for (int received = 0; received < reserved;)
+                {
+                    const size_t count = q.pop_n(batch.begin(), reserved - received);
+                    sum += std::accumulate(batch.begin(), batch.begin() + count, 0LL);
+                    received += static_cast<int>(count);
+                }
+            }
+        });
+
+    for (auto& t : threads)
+        t.join();
+
+    REQUIRE(sum == total);
+    REQUIRE(q.empty());
+}
+
+namespace
+{
+    // baseline for benchmarks
+    template <typename T>
+    class LockedQueue
+    {
+        std::deque<T> q_;
+        std::mutex mtx_;
+        std::condition_variable cv_not_empty_;
+        std::condition_variable cv_not_full_;
+        size_t capacity_;
+
+    public:
+        explicit LockedQueue(size_t capacity)
+            : capacity_ {capacity}
+        {
+        }
+
+        void push(T&& item)
+        {
+            {
+                std::unique_lock lk {mtx_};
+                cv_not_full_.wait(lk, [this] { return q_.size() < capacity_; });
+                q_.push_back(std::move(item));
+            }
+            cv_not_empty_.notify_one();
+        }
+
+        T pop()
+        {
+            std::unique_lock lk {mtx_};
+            cv_not_empty_.wait(lk, [this] { return !q_.empty(); });
+            T item = std::move(q_.front());
+            q_.pop_front();
+            lk.unlock();
+            cv_not_full_.notify_one();
+
+            return item;
+        }
+    };
+
+    template <typename TQueue>
+    void run_throughput(int no_of_threads, int no_of_items)
+    {
+        TQueue q {1024};
+        std::vector<std::thread> threads;
+
+        const int items_per_thread = no_of_items / no_of_threads;
+
+        for (int i = 0; i < no_of_threads; ++i)
+        {
+            threads.emplace_back([&q, items_per_thread] {
+                for (int i = 0; i < items_per_thread; ++i)
+                    q.push(int {i});
+            });
+            threads.emplace_back([&q, items_per_thread] {
+                for (int i = 0; i < items_per_thread; ++i)
+                    q.pop();
+            });
+        }
+
+        for (auto& t : threads)
+            t.join();
+    }
+}
+
+TEST_CASE("MpmcQueue - throughput", "[.][benchmark]")
+{
+    const int no_of_items = 100'000;
+    const int max_threads = std::max(2, static_cast<int>(std::thread::hardware_concurrency()));
+
+    for (int no_of_threads = 1; no_of_threads <= max_threads; no_of_threads *= 2)
+    {
+        const std::string threads_desc = std::to_string(no_of_threads) + " producers/" + std::to_string(no_of_threads) + " consumers";
+
+        BENCHMARK("MpmcQueue - " + threads_desc)
+        {
+            run_throughput<MpmcQueue<int>>(no_of_threads, no_of_items);
+        };
+
+        BENCHMARK("mutex + deque - " + threads_desc)
+        {
+            run_throughput<LockedQueue<int>>(no_of_threads, no_of_items);
+        };
+    }
+}
@@ -0,0 +1,337 @@
+#ifndef UNIQUE_PTR_HPP
+#define UNIQUE_PTR_HPP
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+////////////////////////////////////////////////
+// implementation of unique_ptr - only moveable type
+//
+// Deleter is stored using empty base optimization - stateless deleters
+// do not increase size of the pointer.
+
+template <typename T>
+struct DefaultDelete
+{
+    constexpr DefaultDelete() noexcept = default;
+
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    DefaultDelete(const DefaultDelete<U>&) noexcept
+    {
+    }
+
+    void operator()(T* ptr) const
+    {
+        static_assert(sizeof(T) > 0, "cannot delete an incomplete type");
+        delete ptr;
+    }
+};
+
+template <typename T>
+struct DefaultDelete<T[]>
+{
+    constexpr DefaultDelete() noexcept = default;
+
+    void operator()(T* ptr) const
+    {
+        static_assert(sizeof(T) > 0, "cannot delete an incomplete type");
+        delete[] ptr;
+    }
+};
+
+namespace Details
+{
+    // pair of pointer & deleter - empty deleter is a base class and takes no space
+    template <typename T, typename TDeleter, bool = std::is_empty_v<TDeleter> && !std::is_final_v<TDeleter>>
+    class PointerWithDeleter : private TDeleter
+    {
+        T* ptr_;
+
+    public:
+        template <typename D>
+        PointerWithDeleter(T* ptr, D&& deleter) noexcept
+            : TDeleter(std::forward<D>(deleter))
+            , ptr_ {ptr}
+        {
+        }
+
+        T*& pointer() noexcept
+        {
+            return ptr_;
+        }
+
+        T* pointer() const noexcept
+        {
+            return ptr_;
+        }
+
+        TDeleter& deleter() noexcept
+        {
+            return *this;
+        }
+
+        const TDeleter& deleter() const noexcept
+        {
+            return *this;
+        }
+    };
+
+    template <typename T, typename TDeleter>
+    class PointerWithDeleter<T, TDeleter, false>
+    {
+        T* ptr_;
+        TDeleter deleter_;
+
+    public:
+        template <typename D>
+        PointerWithDeleter(T* ptr, D&& deleter) noexcept
+            : ptr_ {ptr}
+            , deleter_(std::forward<D>(deleter))
+        {
+        }
+
+        T*& pointer() noexcept
+        {
+            return ptr_;
+        }
+
+        T* pointer() const noexcept
+        {
+            return ptr_;
+        }
+
+        TDeleter& deleter() noexcept
+        {
+            return deleter_;
+        }
+
+        const TDeleter& deleter() const noexcept
+        {
+            return deleter_;
+        }
+    };
+
+    // common part of UniquePtr<T> & UniquePtr<T[]>
+    template <typename T, typename TDeleter>
+    class UniquePtrBase
+    {
+    protected:
+        PointerWithDeleter<T, TDeleter> impl_;
+
+    public:
+        using pointer = T*;
+        using element_type = T;
+        using deleter_type = TDeleter;
+
+        UniquePtrBase() noexcept
+            : impl_ {nullptr, TDeleter {}}
+        {
+        }
+
+        explicit UniquePtrBase(T* ptr) noexcept
+            : impl_ {ptr, TDeleter {}}
+        {
+        }
+
+        template <typename D>
+        UniquePtrBase(T* ptr, D&& deleter) noexcept
+            : impl_ {ptr, std::forward<D>(deleter)}
+        {
+        }
+
+        UniquePtrBase(const UniquePtrBase&) = delete;
+        UniquePtrBase& operator=(const UniquePtrBase&) = delete;
+
+        UniquePtrBase(UniquePtrBase&& other) noexcept // move constructor
+            : impl_ {other.release(), std::move(other.get_deleter())}
+        {
+        }
+
+        UniquePtrBase& operator=(UniquePtrBase&& other) noexcept // move assignment
+        {
+            if (this != &other)
+            {
+                reset(other.release()); // release previous state & transfer state from other to this
+                get_deleter() = std::move(other.get_deleter());
+            }
+
+            return *this;
+        }
+
+        ~UniquePtrBase()
+        {
+            if (impl_.pointer())
+                impl_.deleter()(impl_.pointer());
+        }
+
+        T* get() const noexcept
+        {
+            return impl_.pointer();
+        }
+
+        TDeleter& get_deleter() noexcept
+        {
+            return impl_.deleter();
+        }
+
+        const TDeleter& get_deleter() const noexcept
+        {
+            return impl_.deleter();
+        }
+
+        explicit operator bool() const noexcept
+        {
+            return impl_.pointer() != nullptr;
+        }
+
+        [[nodiscard]] T* release() noexcept
+        {
+            return std::exchange(impl_.pointer(), nullptr);
+        }
+
+        void reset(T* ptr = nullptr) noexcept
+        {
+            T* old_ptr = std::exchange(impl_.pointer(), ptr);
+
+            if (old_ptr)
+                impl_.deleter()(old_ptr);
+        }
+
+        void swap(UniquePtrBase& other) noexcept
+        {
+            using std::swap;
+            swap(impl_.pointer(), other.impl_.pointer());
+            swap(impl_.deleter(), other.impl_.deleter());
+        }
+    };
+}
+
+template <typename T, typename TDeleter = DefaultDelete<T>>
+class UniquePtr : public Details::UniquePtrBase<T, TDeleter>
+{
+    using Base = Details::UniquePtrBase<T, TDeleter>;
+
+public:
+    using Base::Base;
+
+    UniquePtr() noexcept = default;
+
+    UniquePtr(std::nullptr_t) noexcept
+    {
+    }
+
+    // converting move constructor - e.g. UniquePtr<Derived> -> UniquePtr<Base>
+    template <typename U, typename E,
+        typename = std::enable_if_t<!std::is_array_v<U> && std::is_convertible_v<U*, T*> && std::is_convertible_v<E, TDeleter>>>
+    UniquePtr(UniquePtr<U, E>&& other) noexcept
+        : Base(other.release(), std::move(other.get_deleter()))
+    {
+    }
+
+    template <typename U, typename E,
+        typename = std::enable_if_t<!std::is_array_v<U> && std::is_convertible_v<U*, T*> && std::is_assignable_v<TDeleter&, E&&>>>
+    UniquePtr& operator=(UniquePtr<U, E>&& other) noexcept
+    {
+        this->reset(other.release());
+        this->get_deleter() = std::move(other.get_deleter());
+
+        return *this;
+    }
+
+    T* operator->() const noexcept
+    {
+        return this->get();
+    }
+
+    T& operator*() const
+    {
+        return *this->get();
+    }
+};
+
+template <typename T, typename TDeleter>
+class UniquePtr<T[], TDeleter> : public Details::UniquePtrBase<T, TDeleter>
+{
+    using Base = Details::UniquePtrBase<T, TDeleter>;
+
+public:
+    using Base::Base;
+
+    UniquePtr() noexcept = default;
+
+    UniquePtr(std::nullptr_t) noexcept
+    {
+    }
+
+    // delete[] of array of derived objects through T* is UB - only T* is accepted (as in std::unique_ptr<T[]>)
+    template <typename U, typename = std::enable_if_t<!std::is_same_v<U, T>>>
+    explicit UniquePtr(U* ptr) = delete;
+
+    template <typename U, typename D, typename = std::enable_if_t<!std::is_same_v<U, T>>>
+    UniquePtr(U* ptr, D&& deleter) = delete;
+
+    using Base::reset;
+
+    template <typename U, typename = std::enable_if_t<!std::is_same_v<U, T>>>
+    void reset(U* ptr) = delete;
+
+    T& operator[](size_t index) const
+    {
+        return this->get()[index];
+    }
+};
+
+template <typename T, typename TDeleter>
+void swap(UniquePtr<T, TDeleter>& a, UniquePtr<T, TDeleter>& b) noexcept
+{
+    a.swap(b);
+}
+
+template <typename T, typename TDeleter>
+bool operator==(const UniquePtr<T, TDeleter>& ptr, std::nullptr_t) noexcept
+{
+    return !ptr;
+}
+
+template <typename T, typename TDeleter>
+bool operator!=(const UniquePtr<T, TDeleter>& ptr, std::nullptr_t) noexcept
+{
+    return static_cast<bool>(ptr);
+}
+
+// single object
+template <typename T, typename... TArgs>
+std::enable_if_t<!std::is_array_v<T>, UniquePtr<T>> MakeUnique(TArgs&&... args)
+{
+    return UniquePtr<T> {new T(std::forward<TArgs>(args)...)};
+}
+
+// array of size items - items are value-initialized (zeroed for trivial types)
+template <typename T>
+std::enable_if_t<std::is_array_v<T> && std::extent_v<T> == 0, UniquePtr<T>> MakeUnique(size_t size)
+{
+    return UniquePtr<T> {new std::remove_extent_t<T>[size]()};
+}
+
+template <typename T, typename... TArgs>
+std::enable_if_t<(std::extent_v<T> != 0)> MakeUnique(TArgs&&...) = delete;
+
+// single object - default-initialized (left uninitialized for trivial types)
+template <typename T>
+std::enable_if_t<!std::is_array_v<T>, UniquePtr<T>> MakeUniqueForOverwrite()
+{
+    return UniquePtr<T> {new T};
+}
+
+// array of size items - default-initialized, big buffers are not zeroed
+template <typename T>
+std::enable_if_t<std::is_array_v<T> && std::extent_v<T> == 0, UniquePtr<T>> MakeUniqueForOverwrite(size_t size)
+{
+    return UniquePtr<T> {new std::remove_extent_t<T>[size]};
+}
+
+template <typename T, typename... TArgs>
+std::enable_if_t<(std::extent_v<T> != 0)> MakeUniqueForOverwrite(TArgs&&...) = delete;
+
+#endif // UNIQUE_PTR_HPP
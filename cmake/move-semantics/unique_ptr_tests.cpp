@@ -0,0 +1,194 @@
+#include "allocation_counter.hpp"
+#include "catch.hpp"
+#include "gadget.hpp"
+#include "unique_ptr.hpp"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace
+{
+    struct CountingDeleter
+    {
+        int* counter;
+
+        void operator()(int* ptr) const
+        {
+            ++*counter;
+            delete ptr;
+        }
+    };
+
+    struct FileCloser
+    {
+        void operator()(FILE* f) const
+        {
+            fclose(f);
+        }
+    };
+
+    struct Base
+    {
+        virtual ~Base() = default;
+        virtual std::string id() const { return "Base"; }
+    };
+
+    struct Derived : Base
+    {
+        std::string id() const override { return "Derived"; }
+    };
+}
+
+// stateless deleters cost zero bytes
+static_assert(sizeof(UniquePtr<int>) == sizeof(int*));
+static_assert(sizeof(UniquePtr<int[]>) == sizeof(int*));
+static_assert(sizeof(UniquePtr<Gadget>) == sizeof(Gadget*));
+static_assert(sizeof(UniquePtr<FILE, FileCloser>) == sizeof(FILE*));
+
+namespace
+{
+    auto lambda_closer = [](FILE* f) { fclose(f); };
+}
+
+static_assert(sizeof(UniquePtr<FILE, decltype(lambda_closer)>) == sizeof(FILE*));
+
+// function pointers and stateful deleters have to be stored
+static_assert(sizeof(UniquePtr<FILE, int (*)(FILE*)>) == 2 * sizeof(FILE*));
+static_assert(sizeof(UniquePtr<int, CountingDeleter>) == 2 * sizeof(int*));
+
+static_assert(!std::is_copy_constructible_v<UniquePtr<int>>);
+static_assert(std::is_nothrow_move_constructible_v<UniquePtr<int>>);
+static_assert(std::is_nothrow_move_assignable_v<UniquePtr<int[]>>);
+
+// array of derived objects cannot be deleted through pointer to base
+static_assert(std::is_constructible_v<UniquePtr<Base>, Derived*>);
+static_assert(std::is_constructible_v<UniquePtr<Base[]>, Base*>);
+static_assert(!std::is_constructible_v<UniquePtr<Base[]>, Derived*>);
+static_assert(!std::is_constructible_v<UniquePtr<Base[]>, Derived*, DefaultDelete<Base[]>>);
+
+TEST_CASE("UniquePtr - dereferencing")
+{
+    UniquePtr<Gadget> ptr = MakeUnique<Gadget>(1, "ipad");
+
+    Gadget& g = *ptr;
+
+    REQUIRE(&g == ptr.get());
+    REQUIRE(g.name == "ipad");
+    REQUIRE(ptr->value == 1);
+}
+
+TEST_CASE("UniquePtr - reset, release & swap")
+{
+    int deleted = 0;
+    UniquePtr<int, CountingDeleter> ptr {new int(1), CountingDeleter {&deleted}};
+
+    SECTION("reset deletes previous object")
+    {
+        ptr.reset(new int(2));
+        REQUIRE(deleted == 1);
+        REQUIRE(*ptr == 2);
+
+        ptr.reset();
+        REQUIRE(deleted == 2);
+        REQUIRE(ptr == nullptr);
+    }
+
+    SECTION("release gives up ownership")
+    {
+        int* raw = ptr.release();
+
+        REQUIRE(ptr == nullptr);
+        REQUIRE(*raw == 1);
+
+        delete raw;
+    }
+
+    SECTION("swap exchanges pointers & deleters")
+    {
+        int other_deleted = 0;
+        UniquePtr<int, CountingDeleter> other {new int(2), CountingDeleter {&other_deleted}};
+
+        swap(ptr, other);
+
+        REQUIRE(*ptr == 2);
+        REQUIRE(*other == 1);
+        REQUIRE(ptr.get_deleter().counter == &other_deleted);
+
+        ptr.reset();
+        REQUIRE(other_deleted == 1);
+        REQUIRE(deleted == 0);
+    }
+
+    SECTION("move transfers deleter")
+    {
+        UniquePtr<int, CountingDeleter> target = std::move(ptr);
+
+        REQUIRE(ptr == nullptr);
+
+        target.reset();
+        REQUIRE(deleted == 1);
+    }
+}
+
+TEST_CASE("UniquePtr - converting move")
+{
+    UniquePtr<Derived> derived = MakeUnique<Derived>();
+
+    UniquePtr<Base> base = std::move(derived);
+    REQUIRE(base->id() == "Derived");
+    REQUIRE(derived == nullptr);
+
+    base = MakeUnique<Derived>();
+    REQUIRE(base->id() == "Derived");
+}
+
+TEST_CASE("UniquePtr<T[]>")
+{
+    SECTION("MakeUnique value-initializes items")
+    {
+        UniquePtr<int[]> tab = MakeUnique<int[]>(100);
+
+        for (size_t i = 0; i < 100; ++i)
+            REQUIRE(tab[i] == 0);
+
+        tab[0] = 42;
+        REQUIRE(tab.get()[0] == 42);
+    }
+
+    SECTION("MakeUniqueForOverwrite leaves trivial items uninitialized")
+    {
+        AllocationCounter::Scope allocs;
+
+        UniquePtr<int[]> buffer = MakeUniqueForOverwrite<int[]>(1'000'000);
+        buffer[999'999] = 1;
+
+        REQUIRE(allocs.count() == 1);
+        REQUIRE(buffer[999'999] == 1);
+    }
+
+    SECTION("MakeUniqueForOverwrite default-constructs non-trivial items")
+    {
+        UniquePtr<std::string[]> words = MakeUniqueForOverwrite<std::string[]>(3);
+
+        REQUIRE(words[2].empty());
+    }
+
+    SECTION("array deleter")
+    {
+        UniquePtr<std::vector<int>[]> vecs {new std::vector<int>[2]};
+        vecs[1].push_back(1);
+
+        vecs.reset();
+        REQUIRE(vecs == nullptr);
+    }
+}
+
+TEST_CASE("UniquePtr - FILE with stateless deleter")
+{
+    UniquePtr<FILE, FileCloser> f {tmpfile()};
+
+    REQUIRE(f);
+    REQUIRE(fprintf(f.get(), "text") == 4);
+}
@@ -1,3 +1,4 @@
+#include "ownership_tracker.hpp"
 #include <iostream>
 #include <memory>
 #include <string>
@@ -55,7 +56,103 @@ void memory_leak_demo()
     person1->description();
 }
 
+// Human with shared_ptr to the partner - couple is never destroyed
+class CyclicHuman
+{
+public:
+    CyclicHuman(std::string name)
+        : name_(std::move(name))
+    {
+    }
+
+    void set_partner(std::shared_ptr<CyclicHuman> partner)
+    {
+        partner_ = partner;
+    }
+
+    void leave_partner()
+    {
+        partner_ = nullptr;
+    }
+
+private:
+    Ownership::SharedPtr<CyclicHuman> partner_;
+    std::string name_;
+};
+
+int no_of_failures = 0;
+
+void check(bool condition, const char* description)
+{
+    if (!condition)
+    {
+        std::cout << "FAILED: " << description << std::endl;
+        ++no_of_failures;
+    }
+}
+
+void cycle_detection_test()
+{
+#if OWNERSHIP_TRACKING
+    std::weak_ptr<CyclicHuman> observer;
+
+    {
+        auto person1 = Ownership::make_tracked<CyclicHuman>("Jan");
+        auto person2 = Ownership::make_tracked<CyclicHuman>("Ewa");
+        observer = person1;
+
+        person1->set_partner(person2);
+        person2->set_partner(person1);
+
+        const auto report = Ownership::analyze();
+        check(report.live_objects.size() == 2, "two live objects");
+        check(report.unreachable_objects.empty(), "couple is reachable from person1");
+        check(report.cycles.size() == 1 && report.cycles[0].size() == 2, "cycle of couple is detected");
+    }
+
+    const auto report = Ownership::analyze();
+    std::cout << "\nOwnership report after couple went out of scope:\n";
+    Ownership::print(std::cout, report);
+
+    check(report.live_objects.size() == 2, "couple is leaked");
+    check(report.unreachable_objects.size() == 2, "leaked couple is unreachable");
+    check(report.cycles.size() == 1 && report.cycles[0].size() == 2, "cycle of leaked couple is reported");
+
+    // cycle broken - couple is destroyed
+    observer.lock()->leave_partner();
+    check(observer.expired(), "couple is destroyed when cycle is broken");
+    check(Ownership::Tracker::instance().no_of_live_objects() == 0, "no live objects");
+
+    {
+        auto loner = Ownership::make_tracked<CyclicHuman>("Narcyz");
+        loner->set_partner(loner);
+
+        auto a = Ownership::make_tracked<CyclicHuman>("A");
+        auto b = Ownership::make_tracked<CyclicHuman>("B");
+        auto c = Ownership::make_tracked<CyclicHuman>("C");
+        a->set_partner(b);
+        b->set_partner(c); // chain - no cycle
+
+        const auto report = Ownership::analyze();
+        check(report.cycles.size() == 1 && report.cycles[0].size() == 1, "self-loop is a cycle & chain is not");
+        check(report.live_objects.size() == 4, "four live objects");
+        check(report.unreachable_objects.empty(), "objects are reachable from local owners");
+
+        loner->leave_partner();
+    }
+
+    check(Ownership::Tracker::instance().no_of_live_objects() == 0, "no leaks without cycles");
+#else
+    static_assert(sizeof(Ownership::SharedPtr<CyclicHuman>) == sizeof(std::shared_ptr<CyclicHuman>), "no overhead when tracking is disabled");
+    std::cout << "\nOwnership tracking is disabled - build without NDEBUG or define OWNERSHIP_TRACKING=1" << std::endl;
+#endif
+}
+
 int main()
 {
     memory_leak_demo();
+
+    cycle_detection_test();
+
+    return no_of_failures == 0 ? 0 : 1;
 }
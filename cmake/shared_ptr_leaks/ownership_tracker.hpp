@@ -0,0 +1,465 @@
+#ifndef OWNERSHIP_TRACKER_HPP
+#define OWNERSHIP_TRACKER_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <typeinfo>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////
+// Ownership graph diagnostics for shared_ptr object graphs
+//
+// Ownership::make_tracked<T>() - make_shared wrapper: object is allocated by TrackingAllocator,
+// which records it in Tracker while it is alive. Returned SharedPtr<T> - kept in a local variable -
+// is a root of the graph.
+// Ownership::SharedPtr<T> - shared_ptr that records owning edge: pointer stored inside a tracked
+// object is an edge from this object, pointer outside of tracked objects (stack, globals) is a root.
+//
+// Tracker::instance().analyze() gives on demand:
+//  - live objects & objects that are alive but not reachable from roots (leaks)
+//  - strongly connected components of the ownership graph - cycles of shared_ptrs
+//
+// Tracking is enabled in debug builds (NDEBUG not defined) - define OWNERSHIP_TRACKING as 0 or 1
+// to override. When disabled SharedPtr<T> is std::shared_ptr<T> & make_tracked() is std::make_shared() -
+// there is no overhead.
+
+#ifndef OWNERSHIP_TRACKING
+#ifdef NDEBUG
+#define OWNERSHIP_TRACKING 0
+#else
+#define OWNERSHIP_TRACKING 1
+#endif
+#endif
+
+namespace Ownership
+{
+    struct ObjectInfo
+    {
+        const void* address;
+        size_t size;
+        const char* type_name;
+    };
+
+    struct Report
+    {
+        std::vector<ObjectInfo> live_objects;
+        std::vector<ObjectInfo> unreachable_objects; // kept alive by cycles or by untracked owners
+        std::vector<std::vector<ObjectInfo>> cycles;
+    };
+
+    inline std::ostream& operator<<(std::ostream& out, const ObjectInfo& object)
+    {
+        return out << object.type_name << " at " << object.address;
+    }
+
+    inline void print(std::ostream& out, const Report& report)
+    {
+        out << "Live objects: " << report.live_objects.size() << "\n";
+
+        out << "Unreachable from roots: " << report.unreachable_objects.size() << "\n";
+        for (const auto& object : report.unreachable_objects)
+            out << "  " << object << "\n";
+
+        out << "Cycles: " << report.cycles.size() << "\n";
+        for (const auto& cycle : report.cycles)
+        {
+            out << "  cycle of " << cycle.size() << " object(s):\n";
+            for (const auto& object : cycle)
+                out << "    " << object << "\n";
+        }
+    }
+
+    class Tracker
+    {
+        struct ObjectEntry
+        {
+            size_t size;
+            const char* type_name;
+        };
+
+        std::mutex mtx_;
+        std::map<const void*, ObjectEntry> objects_;                 // ordered - finding object containing address
+        std::unordered_map<const void*, const void*> pointers_;    // address of SharedPtr -> pointee
+
+        Tracker() = default;
+
+        // mtx_ must be locked - returns objects_.end() if address is not inside of a live object
+        std::map<const void*, ObjectEntry>::const_iterator containing_object(const void* address) const
+        {
+            auto pos = objects_.upper_bound(address);
+            if (pos == objects_.begin())
+                return objects_.end();
+
+            --pos;
+            const char* begin = static_cast<const char*>(pos->first);
+            const char* target = static_cast<const char*>(address);
+
+            return (std::less_equal<const char*>{}(begin, target) && std::less<const char*>{}(target, begin + pos->second.size))
+                ? pos
+                : objects_.end();
+        }
+
+        // Tarjan's algorithm (iterative) - components with more than one object or with a self-loop
+        static std::vector<std::vector<size_t>> find_cycles(const std::vector<std::vector<size_t>>& edges)
+        {
+            const size_t no_of_nodes = edges.size();
+            const size_t unvisited = static_cast<size_t>(-1);
+
+            std::vector<size_t> index(no_of_nodes, unvisited), low_link(no_of_nodes, 0);
+            std::vector<bool> on_stack(no_of_nodes, false);
+            std::vector<size_t> stack;
+            std::vector<std::pair<size_t, size_t>> call_stack; // node & index of next edge
+            std::vector<std::vector<size_t>> cycles;
+            size_t next_index = 0;
+
+            for (size_t start = 0; start < no_of_nodes; ++start)
+            {
+                if (index[start] != unvisited)
+                    continue;
+
+                call_stack.emplace_back(start, 0);
+
+                while (!call_stack.empty())
+                {
+                    const size_t node = call_stack.back().first;
+                    size_t& next_edge = call_stack.back().second;
+
+                    if (next_edge == 0 && index[node] == unvisited)
+                    {
+                        index[node] = low_link[node] = next_index++;
+                        stack.push_back(node);
+                        on_stack[node] = true;
+                    }
+
+                    if (next_edge < edges[node].size())
+                    {
+                        const size_t target = edges[node][next_edge++];
+
+                        if (index[target] == unvisited)
+                            call_stack.emplace_back(target, 0);
+                        else if (on_stack[target])
+                            low_link[node] = std::min(low_link[node], index[target]);
+
+                        continue;
+                    }
+
+                    if (low_link[node] == index[node])
+                    {
+                        std::vector<size_t> component;
+                        size_t member;
+                        do
+                        {
+                            member = stack.back();
+                            stack.pop_back();
+                            on_stack[member] = false;
+                            component.push_back(member);
+                        } while (member != node);
+
+                        const bool self_loop = std::find(edges[node].begin(), edges[node].end(), node) != edges[node].end();
+                        if (component.size() > 1 || self_loop)
+                            cycles.push_back(std::move(component));
+                    }
+
+                    call_stack.pop_back();
+                    if (!call_stack.empty())
+                    {
+                        const size_t parent = call_stack.back().first;
+                        low_link[parent] = std::min(low_link[parent], low_link[node]);
+                    }
+                }
+            }
+
+            return cycles;
+        }
+
+    public:
+        Tracker(const Tracker&) = delete;
+        Tracker& operator=(const Tracker&) = delete;
+
+        static Tracker& instance()
+        {
+            static Tracker tracker;
+            return tracker;
+        }
+
+        void add_object(const void* address, size_t size, const char* type_name)
+        {
+            std::lock_guard<std::mutex> lk{mtx_};
+            objects_[address] = ObjectEntry{size, type_name};
+        }
+
+        void remove_object(const void* address)
+        {
+            std::lock_guard<std::mutex> lk{mtx_};
+            objects_.erase(address);
+        }
+
+        // pointee == nullptr removes the pointer
+        void set_pointer(const void* pointer, const void* pointee)
+        {
+            std::lock_guard<std::mutex> lk{mtx_};
+
+            if (pointee)
+                pointers_[pointer] = pointee;
+            else
+                pointers_.erase(pointer);
+        }
+
+        size_t no_of_live_objects()
+        {
+            std::lock_guard<std::mutex> lk{mtx_};
+            return objects_.size();
+        }
+
+        Report analyze()
+        {
+            std::lock_guard<std::mutex> lk{mtx_};
+
+            Report report;
+            std::map<const void*, size_t> node_of;
+            for (const auto& object : objects_)
+            {
+                node_of[object.first] = report.live_objects.size();
+                report.live_objects.push_back(ObjectInfo{object.first, object.second.size, object.second.type_name});
+            }
+
+            std::vector<std::vector<size_t>> edges(report.live_objects.size());
+            std::vector<size_t> roots;
+
+            for (const auto& pointer : pointers_)
+            {
+                auto target = containing_object(pointer.second);
+                if (target == objects_.end())
+                    continue; // pointee is not tracked
+
+                auto owner = containing_object(pointer.first);
+                if (owner == objects_.end())
+                    roots.push_back(node_of[target->first]);
+                else
+                    edges[node_of[owner->first]].push_back(node_of[target->first]);
+            }
+
+            std::vector<bool> reachable(edges.size(), false);
+            while (!roots.empty())
+            {
+                const size_t node = roots.back();
+                roots.pop_back();
+
+                if (reachable[node])
+                    continue;
+
+                reachable[node] = true;
+                roots.insert(roots.end(), edges[node].begin(), edges[node].end());
+            }
+
+            for (size_t node = 0; node < reachable.size(); ++node)
+                if (!reachable[node])
+                    report.unreachable_objects.push_back(report.live_objects[node]);
+
+            for (const auto& component : find_cycles(edges))
+            {
+                std::vector<ObjectInfo> cycle;
+                for (size_t node : component)
+                    cycle.push_back(report.live_objects[node]);
+                report.cycles.push_back(std::move(cycle));
+            }
+
+            return report;
+        }
+    };
+
+    // records objects constructed by allocate_shared() in Tracker
+    template <typename T>
+    class TrackingAllocator
+    {
+    public:
+        using value_type = T;
+
+        TrackingAllocator() = default;
+
+        template <typename U>
+        TrackingAllocator(const TrackingAllocator<U>&) noexcept
+        {
+        }
+
+        T* allocate(size_t n)
+        {
+            return std::allocator<T>{}.allocate(n);
+        }
+
+        void deallocate(T* p, size_t n) noexcept
+        {
+            std::allocator<T>{}.deallocate(p, n);
+        }
+
+        template <typename U, typename... TArgs>
+        void construct(U* p, TArgs&&... args)
+        {
+            ::new (static_cast<void*>(p)) U(std::forward<TArgs>(args)...);
+            Tracker::instance().add_object(p, sizeof(U), typeid(U).name());
+        }
+
+        template <typename U>
+        void destroy(U* p)
+        {
+            Tracker::instance().remove_object(p);
+            p->~U();
+        }
+
+        template <typename U>
+        bool operator==(const TrackingAllocator<U>&) const noexcept
+        {
+            return true;
+        }
+
+        template <typename U>
+        bool operator!=(const TrackingAllocator<U>&) const noexcept
+        {
+            return false;
+        }
+    };
+
+    // shared_ptr that records itself as an owning edge
+    template <typename T>
+    class TrackedPtr
+    {
+        std::shared_ptr<T> ptr_;
+
+        template <typename U>
+        friend class TrackedPtr;
+
+        void record() const
+        {
+            Tracker::instance().set_pointer(this, ptr_.get());
+        }
+
+    public:
+        TrackedPtr() noexcept = default;
+
+        TrackedPtr(std::nullptr_t) noexcept
+        {
+        }
+
+        template <typename U>
+        TrackedPtr(std::shared_ptr<U> ptr)
+            : ptr_(std::move(ptr))
+        {
+            record();
+        }
+
+        TrackedPtr(const TrackedPtr& other)
+            : ptr_(other.ptr_)
+        {
+            record();
+        }
+
+        template <typename U>
+        TrackedPtr(const TrackedPtr<U>& other)
+            : ptr_(other.ptr_)
+        {
+            record();
+        }
+
+        TrackedPtr(TrackedPtr&& other)
+            : ptr_(std::move(other.ptr_))
+        {
+            other.record();
+            record();
+        }
+
+        TrackedPtr& operator=(TrackedPtr other)
+        {
+            ptr_.swap(other.ptr_);
+            other.record();
+            record();
+            return *this;
+        }
+
+        ~TrackedPtr()
+        {
+            if (ptr_)
+                Tracker::instance().set_pointer(this, nullptr);
+        }
+
+        void reset()
+        {
+            ptr_.reset();
+            record();
+        }
+
+        T* get() const noexcept
+        {
+            return ptr_.get();
+        }
+
+        T& operator*() const noexcept
+        {
+            return *ptr_;
+        }
+
+        T* operator->() const noexcept
+        {
+            return ptr_.get();
+        }
+
+        explicit operator bool() const noexcept
+        {
+            return ptr_ != nullptr;
+        }
+
+        long use_count() const noexcept
+        {
+            return ptr_.use_count();
+        }
+
+        operator std::shared_ptr<T>() const
+        {
+            return ptr_;
+        }
+
+        operator std::weak_ptr<T>() const
+        {
+            return ptr_;
+        }
+    };
+
+#if OWNERSHIP_TRACKING
+    template <typename T>
+    using SharedPtr = TrackedPtr<T>;
+
+    template <typename T, typename... TArgs>
+    SharedPtr<T> make_tracked(TArgs&&... args)
+    {
+        return SharedPtr<T>(std::allocate_shared<T>(TrackingAllocator<T>{}, std::forward<TArgs>(args)...));
+    }
+#else
+    template <typename T>
+    using SharedPtr = std::shared_ptr<T>;
+
+    template <typename T, typename... TArgs>
+    SharedPtr<T> make_tracked(TArgs&&... args)
+    {
+        return std::make_shared<T>(std::forward<TArgs>(args)...);
+    }
+#endif
+
+    // report of tracked graph - empty if tracking is disabled
+    inline Report analyze()
+    {
+#if OWNERSHIP_TRACKING
+        return Tracker::instance().analyze();
+#else
+        return Report{};
+#endif
+    }
+}
+
+#endif // OWNERSHIP_TRACKER_HPP
@@ -0,0 +1,547 @@
+#ifndef ASYNC_IO_HPP
+#define ASYNC_IO_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////
+// Asynchronous file I/O
+//
+// IoThreadPool - fixed number of threads - no more than size() operations are in progress.
+// Future<T>::then() schedules continuation in the pool when the result is ready - no thread waits
+// for an intermediate result. Continuation returning Future<U> gives Future<U> (load -> transform -> save).
+// Cancelled operations (CancellationSource::cancel()) & continuations of failed or cancelled operations
+// are not run - their futures hold the exception (OperationCancelled).
+// Continuation is run by the pool of the future it is attached to. If that pool is already destroyed
+// the future of the continuation holds std::future_error (broken_promise).
+
+namespace AsyncIo
+{
+    class OperationCancelled : public std::runtime_error
+    {
+    public:
+        OperationCancelled()
+            : std::runtime_error {"operation cancelled"}
+        {
+        }
+    };
+
+    namespace Details
+    {
+        struct CancellationState
+        {
+            std::mutex mtx;
+            std::condition_variable cv;
+            bool cancelled = false;
+        };
+    }
+
+    class CancellationToken
+    {
+        std::shared_ptr<Details::CancellationState> state_; // nullptr - never cancelled
+
+        friend class CancellationSource;
+
+        explicit CancellationToken(std::shared_ptr<Details::CancellationState> state)
+            : state_ {std::move(state)}
+        {
+        }
+
+    public:
+        CancellationToken() = default;
+
+        bool is_cancelled() const
+        {
+            if (!state_)
+                return false;
+
+            std::lock_guard<std::mutex> lk {state_->mtx};
+            return state_->cancelled;
+        }
+
+        void throw_if_cancelled() const
+        {
+            if (is_cancelled())
+                throw OperationCancelled {};
+        }
+
+        // waits for timeout or cancellation - throws OperationCancelled in the latter case
+        template <typename TRep, typename TPeriod>
+        void sleep_for(std::chrono::duration<TRep, TPeriod> timeout) const
+        {
+            if (!state_)
+            {
+                std::this_thread::sleep_for(timeout);
+                return;
+            }
+
+            std::unique_lock<std::mutex> lk {state_->mtx};
+            if (state_->cv.wait_for(lk, timeout, [this] { return state_->cancelled; }))
+                throw OperationCancelled {};
+        }
+    };
+
+    class CancellationSource
+    {
+        std::shared_ptr<Details::CancellationState> state_ = std::make_shared<Details::CancellationState>();
+
+    public:
+        CancellationToken token() const
+        {
+            return CancellationToken {state_};
+        }
+
+        void cancel()
+        {
+            {
+                std::lock_guard<std::mutex> lk {state_->mtx};
+                state_->cancelled = true;
+            }
+            state_->cv.notify_all();
+        }
+
+        bool is_cancelled() const
+        {
+            return token().is_cancelled();
+        }
+    };
+
+    class IoThreadPool;
+
+    template <typename T>
+    class Future;
+
+    namespace Details
+    {
+        // task queue of IoThreadPool - futures keep weak_ptr to it, so they can outlive the pool
+        class PoolQueue
+        {
+            std::mutex mtx_;
+            std::condition_variable cv_;
+            std::deque<std::function<void()>> tasks_;
+            bool done_ = false;
+            size_t no_of_running_ = 0;
+
+        public:
+            // runs tasks until stop() is called & the queue is empty
+            void run()
+            {
+                while (true)
+                {
+                    std::function<void()> task;
+                    {
+                        std::unique_lock<std::mutex> lk {mtx_};
+                        cv_.wait(lk, [this] { return done_ || !tasks_.empty(); });
+
+                        if (tasks_.empty())
+                        {
+                            --no_of_running_;
+                            return;
+                        }
+
+                        task = std::move(tasks_.front());
+                        tasks_.pop_front();
+                    }
+
+                    task();
+                }
+            }
+
+            void start_thread()
+            {
+                std::lock_guard<std::mutex> lk {mtx_};
+                ++no_of_running_;
+            }
+
+            // returns false if all threads are finished - task is not queued
+            // (tasks posted by running tasks are still accepted while the queue is drained)
+            bool post(std::function<void()> task)
+            {
+                {
+                    std::lock_guard<std::mutex> lk {mtx_};
+                    if (done_ && no_of_running_ == 0)
+                        return false;
+
+                    tasks_.push_back(std::move(task));
+                }
+                cv_.notify_one();
+
+                return true;
+            }
+
+            void stop()
+            {
+                {
+                    std::lock_guard<std::mutex> lk {mtx_};
+                    done_ = true;
+                }
+                cv_.notify_all();
+            }
+        };
+
+        template <typename T>
+        struct SharedState
+        {
+            using Value = std::conditional_t<std::is_void<T>::value, std::monostate, T>;
+
+            std::mutex mtx;
+            std::condition_variable cv;
+            std::optional<Value> value;
+            std::exception_ptr error;
+            bool ready = false;
+            std::vector<std::function<void()>> callbacks;
+
+            void set_value(Value v)
+            {
+                complete([&] { value.emplace(std::move(v)); });
+            }
+
+            void set_error(std::exception_ptr e)
+            {
+                complete([&] { error = std::move(e); });
+            }
+
+            // callback is called once - by the thread that completes the state or here if it is ready
+            void on_ready(std::function<void()> callback)
+            {
+                {
+                    std::lock_guard<std::mutex> lk {mtx};
+                    if (!ready)
+                    {
+                        callbacks.push_back(std::move(callback));
+                        return;
+                    }
+                }
+
+                callback();
+            }
+
+        private:
+            template <typename TSetter>
+            void complete(TSetter setter)
+            {
+                std::vector<std::function<void()>> ready_callbacks;
+                {
+                    std::lock_guard<std::mutex> lk {mtx};
+                    setter();
+                    ready = true;
+                    ready_callbacks.swap(callbacks);
+                }
+                cv.notify_all();
+
+                for (auto& callback : ready_callbacks)
+                    callback();
+            }
+        };
+
+        template <typename T>
+        struct IsFuture : std::false_type
+        {
+        };
+
+        template <typename T>
+        struct IsFuture<Future<T>> : std::true_type
+        {
+        };
+
+        // result of f(T) or f() for void
+        template <typename TFunction, typename T>
+        struct ContinuationResult
+        {
+            using type = std::invoke_result_t<TFunction, T>;
+        };
+
+        template <typename TFunction>
+        struct ContinuationResult<TFunction, void>
+        {
+            using type = std::invoke_result_t<TFunction>;
+        };
+
+        template <typename T>
+        struct Unwrapped
+        {
+            using type = T;
+        };
+
+        template <typename T>
+        struct Unwrapped<Future<T>>
+        {
+            using type = T;
+        };
+
+        // stores result of f(args...) in state - exception is stored too
+        template <typename T, typename TFunction, typename... TArgs>
+        void invoke_into(SharedState<T>& state, TFunction& f, TArgs&&... args)
+        {
+            try
+            {
+                if constexpr (std::is_void<T>::value)
+                {
+                    std::invoke(f, std::forward<TArgs>(args)...);
+                    state.set_value(std::monostate {});
+                }
+                else
+                    state.set_value(std::invoke(f, std::forward<TArgs>(args)...));
+            }
+            catch (...)
+            {
+                state.set_error(std::current_exception());
+            }
+        }
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Future<T> - result of asynchronous operation
+    //
+    // Result can be consumed once - by get() or then(). get() blocks, then() does not.
+    // Future without state (default constructed or consumed) throws std::future_error - as std::future.
+
+    template <typename T>
+    class Future
+    {
+        template <typename U>
+        friend class Future;
+        friend class IoThreadPool;
+
+        std::shared_ptr<Details::SharedState<T>> state_;
+        std::weak_ptr<Details::PoolQueue> pool_;
+
+        Future(std::shared_ptr<Details::SharedState<T>> state, std::weak_ptr<Details::PoolQueue> pool)
+            : state_ {std::move(state)}
+            , pool_ {std::move(pool)}
+        {
+        }
+
+        void check_state() const
+        {
+            if (!state_)
+                throw std::future_error {std::future_errc::no_state};
+        }
+
+        // result of source is passed to target when ready - no thread waits for it
+        static void forward(const std::shared_ptr<Details::SharedState<T>>& source, std::shared_ptr<Details::SharedState<T>> target)
+        {
+            source->on_ready([source, target] {
+                if (source->error)
+                    target->set_error(source->error);
+                else
+                    target->set_value(std::move(*source->value));
+            });
+        }
+
+    public:
+        Future() = default;
+
+        bool valid() const noexcept
+        {
+            return state_ != nullptr;
+        }
+
+        bool is_ready() const
+        {
+            check_state();
+
+            std::lock_guard<std::mutex> lk {state_->mtx};
+            return state_->ready;
+        }
+
+        void wait() const
+        {
+            check_state();
+
+            std::unique_lock<std::mutex> lk {state_->mtx};
+            state_->cv.wait(lk, [this] { return state_->ready; });
+        }
+
+        // blocks until result is ready - rethrows exception of the operation
+        T get()
+        {
+            wait();
+            auto state = std::move(state_);
+
+            if (state->error)
+                std::rethrow_exception(state->error);
+
+            if constexpr (!std::is_void<T>::value)
+                return std::move(*state->value);
+        }
+
+        // f(T) (f() for Future<void>) runs in the pool after the result is ready - unless the operation
+        // failed or token is cancelled
+        template <typename TFunction>
+        auto then(TFunction f, CancellationToken token = {})
+        {
+            using Result = typename Details::ContinuationResult<TFunction, T>::type;
+            using NextValue = typename Details::Unwrapped<Result>::type;
+
+            check_state();
+
+            auto source = std::move(state_);
+            auto target = std::make_shared<Details::SharedState<NextValue>>();
+            auto pool = pool_;
+
+            source->on_ready([source, target, pool, f = std::move(f), token]() mutable {
+                auto queue = pool.lock();
+                const bool queued = queue && queue->post([source, target, f = std::move(f), token]() mutable {
+                    if (source->error)
+                    {
+                        target->set_error(source->error);
+                        return;
+                    }
+
+                    if (token.is_cancelled())
+                    {
+                        target->set_error(std::make_exception_ptr(OperationCancelled {}));
+                        return;
+                    }
+
+                    if constexpr (Details::IsFuture<Result>::value)
+                    {
+                        Result inner;
+                        try
+                        {
+                            if constexpr (std::is_void<T>::value)
+                                inner = std::invoke(f);
+                            else
+                                inner = std::invoke(f, std::move(*source->value));
+                        }
+                        catch (...)
+                        {
+                            target->set_error(std::current_exception());
+                            return;
+                        }
+
+                        Result::forward(inner.state_, target);
+                    }
+                    else if constexpr (std::is_void<T>::value)
+                        Details::invoke_into(*target, f);
+                    else
+                        Details::invoke_into(*target, f, std::move(*source->value));
+                });
+
+                if (!queued)
+                    target->set_error(std::make_exception_ptr(std::future_error {std::future_errc::broken_promise}));
+            });
+
+            return Future<NextValue> {std::move(target), std::move(pool)};
+        }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // IoThreadPool - threads for blocking I/O
+    //
+    // Destructor waits for all queued operations & their continuations.
+
+    class IoThreadPool
+    {
+        std::shared_ptr<Details::PoolQueue> queue_ = std::make_shared<Details::PoolQueue>();
+        std::vector<std::thread> threads_;
+
+    public:
+        explicit IoThreadPool(size_t no_of_threads)
+        {
+            if (no_of_threads == 0)
+                throw std::invalid_argument("IoThreadPool needs at least one thread");
+
+            threads_.reserve(no_of_threads);
+            for (size_t i = 0; i < no_of_threads; ++i)
+            {
+                queue_->start_thread();
+                threads_.emplace_back([queue = queue_.get()] { queue->run(); });
+            }
+        }
+
+        IoThreadPool(const IoThreadPool&) = delete;
+        IoThreadPool& operator=(const IoThreadPool&) = delete;
+
+        ~IoThreadPool()
+        {
+            queue_->stop();
+
+            for (auto& t : threads_)
+                t.join();
+        }
+
+        size_t size() const noexcept
+        {
+            return threads_.size();
+        }
+
+        void post(std::function<void()> task)
+        {
+            queue_->post(std::move(task));
+        }
+
+        // f() runs in the pool - it is not started if token is cancelled before
+        template <typename TFunction>
+        auto submit(TFunction f, CancellationToken token = {})
+        {
+            using Result = std::invoke_result_t<TFunction>;
+
+            auto state = std::make_shared<Details::SharedState<Result>>();
+
+            post([state, f = std::move(f), token]() mutable {
+                if (token.is_cancelled())
+                    state->set_error(std::make_exception_ptr(OperationCancelled {}));
+                else
+                    Details::invoke_into(*state, f);
+            });
+
+            return Future<Result> {std::move(state), queue_};
+        }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // file operations - latency simulates slow device, waiting for it can be cancelled
+    // iostreams do not report the cause of a failure - it is reported as std::io_errc::stream
+
+    inline Future<std::string> load_data(IoThreadPool& pool, std::filesystem::path path, CancellationToken token = {},
+        std::chrono::milliseconds latency = std::chrono::milliseconds {0})
+    {
+        return pool.submit(
+            [path = std::move(path), token, latency] {
+                token.sleep_for(latency);
+
+                std::ifstream in {path, std::ios::binary};
+                if (!in)
+                    throw std::system_error(std::make_error_code(std::io_errc::stream), "cannot open " + path.string());
+
+                return std::string {std::istreambuf_iterator<char> {in}, std::istreambuf_iterator<char> {}};
+            },
+            token);
+    }
+
+    inline Future<void> save_to_file(IoThreadPool& pool, std::filesystem::path path, std::string content, CancellationToken token = {},
+        std::chrono::milliseconds latency = std::chrono::milliseconds {0})
+    {
+        return pool.submit(
+            [path = std::move(path), content = std::move(content), token, latency] {
+                token.sleep_for(latency);
+
+                std::ofstream out {path, std::ios::binary | std::ios::trunc};
+                if (!out.write(content.data(), static_cast<std::streamsize>(content.size())).flush())
+                    throw std::system_error(std::make_error_code(std::io_errc::stream), "cannot write " + path.string());
+            },
+            token);
+    }
+}
+
+#endif // ASYNC_IO_HPP
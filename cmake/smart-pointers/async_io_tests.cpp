@@ -0,0 +1,260 @@
+#include "async_io.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+
+using namespace std;
+using namespace AsyncIo;
+namespace fs = std::filesystem;
+
+namespace
+{
+    class TempDir
+    {
+        fs::path path_;
+
+    public:
+        explicit TempDir(const std::string& name)
+            : path_ {fs::temp_directory_path() / ("async_io_tests_" + name)}
+        {
+            fs::remove_all(path_);
+            fs::create_directories(path_);
+        }
+
+        TempDir(const TempDir&) = delete;
+        TempDir& operator=(const TempDir&) = delete;
+
+        ~TempDir()
+        {
+            std::error_code ec;
+            fs::remove_all(path_, ec);
+        }
+
+        fs::path operator/(const std::string& filename) const
+        {
+            return path_ / filename;
+        }
+    };
+
+    void write_file(const fs::path& path, const std::string& content)
+    {
+        std::ofstream {path} << content;
+    }
+
+    std::string read_file(const fs::path& path)
+    {
+        std::ifstream in {path};
+        return std::string {std::istreambuf_iterator<char> {in}, std::istreambuf_iterator<char> {}};
+    }
+
+    std::string to_upper(std::string text)
+    {
+        std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+        return text;
+    }
+
+    double seconds_since(chrono::steady_clock::time_point start)
+    {
+        return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+}
+
+TEST_CASE("Async I/O - load -> transform -> save")
+{
+    TempDir dir {"pipeline"};
+    write_file(dir / "input.txt", "content of input");
+
+    IoThreadPool pool {2};
+
+    Future<void> saved = load_data(pool, dir / "input.txt")
+                             .then(to_upper)
+                             .then([&](std::string text) { return save_to_file(pool, dir / "output.txt", std::move(text)); });
+
+    saved.get();
+
+    REQUIRE(read_file(dir / "output.txt") == "CONTENT OF INPUT");
+}
+
+TEST_CASE("Async I/O - errors are propagated through continuations")
+{
+    TempDir dir {"errors"};
+    IoThreadPool pool {1};
+    atomic<bool> transformed {false};
+
+    Future<std::string> result = load_data(pool, dir / "missing.txt").then([&](std::string text) {
+        transformed = true;
+        return text;
+    });
+
+    REQUIRE_THROWS_AS(result.get(), std::system_error);
+    REQUIRE_FALSE(transformed);
+}
+
+TEST_CASE("Async I/O - future without state")
+{
+    IoThreadPool pool {1};
+
+    SECTION("default constructed")
+    {
+        Future<int> result;
+
+        REQUIRE_FALSE(result.valid());
+        REQUIRE_THROWS_AS(result.is_ready(), std::future_error);
+        REQUIRE_THROWS_AS(result.wait(), std::future_error);
+        REQUIRE_THROWS_AS(result.then([](int x) { return x; }), std::future_error);
+
+        try
+        {
+            result.get();
+            FAIL("get() of future without state has to throw");
+        }
+        catch (const std::future_error& e)
+        {
+            REQUIRE(e.code() == std::future_errc::no_state);
+        }
+    }
+
+    SECTION("consumed")
+    {
+        Future<int> result = pool.submit([] { return 42; });
+        REQUIRE(result.get() == 42);
+
+        REQUIRE_FALSE(result.valid());
+        REQUIRE_THROWS_AS(result.get(), std::future_error);
+
+        Future<int> next = pool.submit([] { return 1; });
+        Future<int> continuation = next.then([](int x) { return x + 1; });
+
+        REQUIRE_THROWS_AS(next.then([](int x) { return x; }), std::future_error);
+        REQUIRE(continuation.get() == 2);
+    }
+}
+
+TEST_CASE("Async I/O - continuation of future that outlived its pool")
+{
+    Future<int> result;
+    {
+        IoThreadPool pool {1};
+        result = pool.submit([] { return 1; });
+    }
+
+    Future<int> next = result.then([](int x) { return x + 1; });
+
+    try
+    {
+        next.get();
+        FAIL("continuation without pool has to fail");
+    }
+    catch (const std::future_error& e)
+    {
+        REQUIRE(e.code() == std::future_errc::broken_promise);
+    }
+}
+
+TEST_CASE("Async I/O - cancellation")
+{
+    TempDir dir {"cancellation"};
+    write_file(dir / "input.txt", "data");
+
+    IoThreadPool pool {1};
+    CancellationSource cancellation;
+    atomic<bool> saved {false};
+
+    const auto start = chrono::steady_clock::now();
+
+    Future<void> result = load_data(pool, dir / "input.txt", cancellation.token(), chrono::seconds {10})
+                              .then([&](std::string) { saved = true; }, cancellation.token());
+
+    SECTION("waiting for slow device is interrupted")
+    {
+        std::this_thread::sleep_for(chrono::milliseconds {20});
+        cancellation.cancel();
+
+        REQUIRE_THROWS_AS(result.get(), OperationCancelled);
+        REQUIRE(seconds_since(start) < 5.0);
+        REQUIRE_FALSE(saved);
+    }
+
+    SECTION("queued operation is not started")
+    {
+        cancellation.cancel();
+
+        Future<std::string> queued = pool.submit([] { return "started"s; }, cancellation.token());
+
+        REQUIRE_THROWS_AS(queued.get(), OperationCancelled);
+        REQUIRE_THROWS_AS(result.get(), OperationCancelled);
+    }
+}
+
+// BUG in C++11 - future returned by std::async blocks in its destructor, so a pipeline
+// std::async(load_data, ...) -> std::async(save_to_file, f.get()) runs loads & saves serially
+TEST_CASE("Async I/O - N loads & N saves take about max latency, not the sum")
+{
+    const size_t n = 4;
+    const auto latency = chrono::milliseconds {200};
+
+    TempDir dir {"latency"};
+    for (size_t i = 0; i < n; ++i)
+        write_file(dir / ("input" + to_string(i) + ".txt"), "content " + to_string(i));
+
+    IoThreadPool pool {n};
+
+    const auto start = chrono::steady_clock::now();
+
+    vector<Future<void>> pipelines;
+    for (size_t i = 0; i < n; ++i)
+    {
+        pipelines.push_back(load_data(pool, dir / ("input" + to_string(i) + ".txt"), {}, latency).then([&, i](std::string text) {
+            return save_to_file(pool, dir / ("output" + to_string(i) + ".txt"), to_upper(std::move(text)), {}, latency);
+        }));
+    }
+
+    for (auto& pipeline : pipelines)
+        pipeline.get();
+
+    const double elapsed = seconds_since(start);
+    const double stage_latency = chrono::duration<double>(latency).count();
+
+    // load & save of every file are sequential - 2 * latency, serial pipeline would take 2 * n * latency
+    REQUIRE(elapsed < 3 * stage_latency);
+
+    for (size_t i = 0; i < n; ++i)
+        REQUIRE(read_file(dir / ("output" + to_string(i) + ".txt")) == "CONTENT " + to_string(i));
+}
+
+TEST_CASE("Async I/O - pool bounds number of concurrent operations")
+{
+    const auto latency = chrono::milliseconds {100};
+
+    IoThreadPool pool {2};
+    atomic<int> in_progress {0};
+    atomic<int> max_in_progress {0};
+
+    vector<Future<void>> operations;
+    for (int i = 0; i < 6; ++i)
+    {
+        operations.push_back(pool.submit([&] {
+            int current = ++in_progress;
+            int max = max_in_progress.load();
+            while (current > max && !max_in_progress.compare_exchange_weak(max, current))
+            {
+            }
+
+            std::this_thread::sleep_for(latency);
+            --in_progress;
+        }));
+    }
+
+    for (auto& operation : operations)
+        operation.get();
+
+    REQUIRE(max_in_progress == 2);
+}
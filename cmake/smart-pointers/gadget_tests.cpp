@@ -0,0 +1,138 @@
+#include "utils.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "catch.hpp"
+
+using namespace std;
+using namespace Utils;
+
+namespace
+{
+    // runs f(thread_index) in no_of_threads threads - returns duration in seconds
+    template <typename TFunction>
+    double run_in_threads(unsigned no_of_threads, TFunction f)
+    {
+        vector<thread> threads;
+        threads.reserve(no_of_threads);
+
+        const auto start = chrono::steady_clock::now();
+
+        for (unsigned i = 0; i < no_of_threads; ++i)
+            threads.emplace_back(f, i);
+
+        for (auto& t : threads)
+            t.join();
+
+        return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+
+    // std::cout without a buffer ignores output - logging of Gadget is discarded in its scope
+    struct DiscardedCout
+    {
+        streambuf* buffer = cout.rdbuf(nullptr);
+
+        ~DiscardedCout()
+        {
+            cout.rdbuf(buffer);
+        }
+    };
+}
+
+TEST_CASE("Gadget - ids are unique for many threads")
+{
+    const unsigned no_of_threads = 4;
+    const size_t ids_per_thread = 3 * Gadget::id_block_size + 7;
+
+    vector<vector<int>> ids(no_of_threads);
+
+    run_in_threads(no_of_threads, [&](unsigned thread_index) {
+        auto& thread_ids = ids[thread_index];
+        for (size_t i = 0; i < ids_per_thread; ++i)
+            thread_ids.push_back(Gadget::gen_id());
+    });
+
+    vector<int> all_ids;
+    for (const auto& thread_ids : ids)
+    {
+        REQUIRE(is_sorted(thread_ids.begin(), thread_ids.end()));
+        all_ids.insert(all_ids.end(), thread_ids.begin(), thread_ids.end());
+    }
+
+    sort(all_ids.begin(), all_ids.end());
+
+    REQUIRE(all_ids.front() > 0);
+    REQUIRE(adjacent_find(all_ids.begin(), all_ids.end()) == all_ids.end());
+}
+
+TEST_CASE("Gadget - name_view is a view of stored name")
+{
+    Gadget g {1, "gadget with a name longer than small string buffer"};
+
+    string_view name = g.name_view();
+
+    REQUIRE(name == "gadget with a name longer than small string buffer");
+    REQUIRE(name.data() == g.name_view().data());
+    REQUIRE(g.name() == name);
+
+    SECTION("moved-from gadget has empty name")
+    {
+        Gadget target = std::move(g);
+
+        REQUIRE(target.name_view().data() == name.data());
+        REQUIRE(g.name_view().empty());
+    }
+}
+
+TEST_CASE("Gadget - creation by many threads", "[.][benchmark]")
+{
+    if (Gadget::logging_enabled)
+        WARN("Gadget logs to std::cout - output is discarded, configure with -DGADGET_PRODUCTION_MODE=ON to compile it out");
+
+    const size_t gadgets_per_thread = 2'000'000;
+
+    // previous implementation - every id is taken from shared counter
+    static atomic<int> shared_id_seed {0};
+
+    for (unsigned no_of_threads : {1u, 2u, 4u, 8u})
+    {
+        atomic<size_t> total_length {0}; // Catch assertions are not thread-safe - checked after join
+        double shared_counter_time, id_block_time;
+        {
+            DiscardedCout discarded;
+
+            shared_counter_time = run_in_threads(no_of_threads, [&](unsigned) {
+                size_t length = 0;
+                for (size_t i = 0; i < gadgets_per_thread; ++i)
+                {
+                    Gadget g {shared_id_seed.fetch_add(1, memory_order_relaxed) + 1, "gadget"};
+                    length += g.name_view().size();
+                }
+                total_length += length;
+            });
+
+            id_block_time = run_in_threads(no_of_threads, [&](unsigned) {
+                size_t length = 0;
+                for (size_t i = 0; i < gadgets_per_thread; ++i)
+                {
+                    Gadget g {Gadget::gen_id(), "gadget"};
+                    length += g.name_view().size();
+                }
+                total_length += length;
+            });
+        }
+
+        REQUIRE(total_length == 2 * 6 * no_of_threads * gadgets_per_thread);
+
+        const double total_gadgets = static_cast<double>(no_of_threads * gadgets_per_thread);
+
+        cout << no_of_threads << " thread(s) - gadgets/s: shared atomic counter = "
+             << static_cast<size_t>(total_gadgets / shared_counter_time)
+             << ", per-thread id blocks = " << static_cast<size_t>(total_gadgets / id_block_time) << "\n";
+    }
+}
@@ -0,0 +1,206 @@
+#ifndef OBJECT_POOL_HPP
+#define OBJECT_POOL_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////
+// ObjectPool<T> - recycles memory of objects of type T
+//
+// Every thread allocates from its own free list without synchronization. Object released by
+// another thread is pushed (lock-free) to the remote list of the thread it came from, the owner
+// takes the whole remote list when its free list is empty. Free list of exited thread is adopted
+// by the next thread that uses the pool - memory is never returned to the system before exit.
+//
+// make() returns unique_ptr with empty deleter - destructor of T is called & slot goes back to the pool.
+
+template <typename T>
+class ObjectPool
+{
+    class LocalCache;
+
+    struct Slot
+    {
+        alignas(T) unsigned char storage[sizeof(T)];
+        LocalCache* home;
+        Slot* next;
+    };
+
+    class LocalCache
+    {
+        Slot* free_ = nullptr;                 // used only by owning thread
+        std::atomic<Slot*> remote_free_ {nullptr}; // returned by other threads
+        std::vector<std::unique_ptr<Slot[]>> chunks_;
+
+    public:
+        Slot* allocate(std::atomic<size_t>& no_of_slots)
+        {
+            if (!free_)
+                free_ = remote_free_.exchange(nullptr, std::memory_order_acquire);
+
+            if (!free_)
+                add_chunk(no_of_slots);
+
+            Slot* slot = free_;
+            free_ = slot->next;
+
+            return slot;
+        }
+
+        void deallocate_local(Slot* slot) noexcept
+        {
+            slot->next = free_;
+            free_ = slot;
+        }
+
+        void deallocate_remote(Slot* slot) noexcept
+        {
+            Slot* head = remote_free_.load(std::memory_order_relaxed);
+            do
+            {
+                slot->next = head;
+            } while (!remote_free_.compare_exchange_weak(head, slot, std::memory_order_release, std::memory_order_relaxed));
+        }
+
+    private:
+        void add_chunk(std::atomic<size_t>& no_of_slots)
+        {
+            auto chunk = std::make_unique<Slot[]>(chunk_size);
+
+            for (size_t i = 0; i < chunk_size; ++i)
+            {
+                chunk[i].home = this;
+                chunk[i].next = (i + 1 < chunk_size) ? &chunk[i + 1] : nullptr;
+            }
+
+            free_ = &chunk[0];
+            chunks_.push_back(std::move(chunk));
+            no_of_slots.fetch_add(chunk_size, std::memory_order_relaxed);
+        }
+    };
+
+    // returns cache to the pool when thread exits
+    struct ThreadCache
+    {
+        LocalCache* cache = ObjectPool::instance().acquire_cache();
+
+        ~ThreadCache()
+        {
+            ObjectPool::instance().abandon_cache(cache);
+        }
+    };
+
+    std::mutex mtx_;
+    std::vector<std::unique_ptr<LocalCache>> caches_;
+    std::vector<LocalCache*> abandoned_caches_;
+    std::atomic<size_t> no_of_slots_ {0};
+
+    ObjectPool() = default;
+
+    LocalCache* acquire_cache()
+    {
+        std::lock_guard<std::mutex> lk {mtx_};
+
+        if (!abandoned_caches_.empty())
+        {
+            LocalCache* cache = abandoned_caches_.back();
+            abandoned_caches_.pop_back();
+            return cache;
+        }
+
+        caches_.push_back(std::make_unique<LocalCache>());
+        return caches_.back().get();
+    }
+
+    void abandon_cache(LocalCache* cache)
+    {
+        std::lock_guard<std::mutex> lk {mtx_};
+        abandoned_caches_.push_back(cache);
+    }
+
+    static LocalCache& local_cache()
+    {
+        thread_local ThreadCache thread_cache;
+        return *thread_cache.cache;
+    }
+
+public:
+    static constexpr size_t chunk_size = 64;
+
+    struct Deleter
+    {
+        void operator()(T* ptr) const noexcept
+        {
+            ptr->~T();
+            ObjectPool::instance().deallocate(ptr);
+        }
+    };
+
+    using Ptr = std::unique_ptr<T, Deleter>;
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    static ObjectPool& instance()
+    {
+        static ObjectPool pool;
+        return pool;
+    }
+
+    // returns uninitialized memory for T
+    void* allocate()
+    {
+        return local_cache().allocate(no_of_slots_)->storage;
+    }
+
+    // ptr must come from allocate() of this pool - object has to be destroyed already
+    void deallocate(void* ptr) noexcept
+    {
+        Slot* slot = reinterpret_cast<Slot*>(ptr);
+        LocalCache& cache = local_cache();
+
+        if (slot->home == &cache)
+            cache.deallocate_local(slot);
+        else
+            slot->home->deallocate_remote(slot);
+    }
+
+    template <typename... TArgs>
+    static Ptr make(TArgs&&... args)
+    {
+        ObjectPool& pool = instance();
+        void* memory = pool.allocate();
+
+        try
+        {
+            return Ptr {new (memory) T(std::forward<TArgs>(args)...)};
+        }
+        catch (...)
+        {
+            pool.deallocate(memory);
+            throw;
+        }
+    }
+
+    // number of slots allocated by all threads - free & used
+    size_t no_of_slots() const noexcept
+    {
+        return no_of_slots_.load(std::memory_order_relaxed);
+    }
+};
+
+template <typename T>
+using PooledPtr = typename ObjectPool<T>::Ptr;
+
+template <typename T, typename... TArgs>
+PooledPtr<T> make_pooled(TArgs&&... args)
+{
+    return ObjectPool<T>::make(std::forward<TArgs>(args)...);
+}
+
+#endif // OBJECT_POOL_HPP
@@ -0,0 +1,174 @@
+#include "object_pool.hpp"
+#include "utils.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "catch.hpp"
+
+using namespace std;
+using namespace Utils;
+
+namespace
+{
+    template <int Tag>
+    struct Tracked
+    {
+        static inline int alive = 0;
+
+        int value;
+
+        explicit Tracked(int v)
+            : value {v}
+        {
+            if (v < 0)
+                throw std::invalid_argument("negative value");
+
+            ++alive;
+        }
+
+        ~Tracked()
+        {
+            --alive;
+        }
+    };
+
+    // address stored here escapes - compiler cannot remove new/delete pair in benchmarks
+    thread_local const void* volatile escaped_address = nullptr;
+}
+
+TEST_CASE("ObjectPool - object is constructed & destroyed")
+{
+    using Item = Tracked<1>;
+
+    {
+        PooledPtr<Item> item = make_pooled<Item>(42);
+
+        static_assert(sizeof(item) == sizeof(Item*));
+        REQUIRE(item->value == 42);
+        REQUIRE(Item::alive == 1);
+    }
+
+    REQUIRE(Item::alive == 0);
+}
+
+TEST_CASE("ObjectPool - released slot is reused by the same thread")
+{
+    using Item = Tracked<2>;
+
+    PooledPtr<Item> item = make_pooled<Item>(1);
+    const Item* address = item.get();
+    item.reset();
+
+    item = make_pooled<Item>(2);
+
+    REQUIRE(item.get() == address);
+    REQUIRE(ObjectPool<Item>::instance().no_of_slots() == ObjectPool<Item>::chunk_size);
+}
+
+TEST_CASE("ObjectPool - exception in constructor returns slot")
+{
+    using Item = Tracked<3>;
+
+    PooledPtr<Item> item = make_pooled<Item>(1);
+    const Item* address = item.get();
+    item.reset();
+
+    REQUIRE_THROWS_AS(make_pooled<Item>(-1), std::invalid_argument);
+    REQUIRE(make_pooled<Item>(2).get() == address);
+}
+
+TEST_CASE("ObjectPool - objects released by other thread are returned to owner")
+{
+    using Item = Tracked<4>;
+    const size_t no_of_items = 3 * ObjectPool<Item>::chunk_size;
+
+    vector<PooledPtr<Item>> items;
+    for (size_t i = 0; i < no_of_items; ++i)
+        items.push_back(make_pooled<Item>(static_cast<int>(i)));
+
+    const size_t no_of_slots = ObjectPool<Item>::instance().no_of_slots();
+
+    thread consumer {[items = std::move(items)]() mutable { items.clear(); }};
+    consumer.join();
+
+    REQUIRE(Item::alive == 0);
+
+    for (size_t i = 0; i < no_of_items; ++i)
+        items.push_back(make_pooled<Item>(static_cast<int>(i)));
+
+    REQUIRE(ObjectPool<Item>::instance().no_of_slots() == no_of_slots);
+}
+
+TEST_CASE("ObjectPool - free list of exited thread is adopted")
+{
+    using Item = Tracked<5>;
+
+    thread {[] { make_pooled<Item>(1); }}.join();
+    const size_t no_of_slots = ObjectPool<Item>::instance().no_of_slots();
+
+    thread {[] { make_pooled<Item>(2); }}.join();
+
+    REQUIRE(ObjectPool<Item>::instance().no_of_slots() == no_of_slots);
+}
+
+TEST_CASE("ObjectPool - get/use/destroy cycle of Gadget", "[.][benchmark]")
+{
+    if (Gadget::logging_enabled)
+    {
+        WARN("Gadget logs to std::cout - configure with -DGADGET_PRODUCTION_MODE=ON");
+        return;
+    }
+
+    const size_t cycles_per_thread = 1'000'000;
+
+    // runs cycle() in no_of_threads threads - returns number of cycles per second
+    auto cycles_per_second = [=](unsigned no_of_threads, auto cycle) {
+        atomic<size_t> total_length {0};
+        vector<thread> threads;
+
+        const auto start = chrono::steady_clock::now();
+
+        for (unsigned i = 0; i < no_of_threads; ++i)
+            threads.emplace_back([&] {
+                size_t length = 0;
+                for (size_t c = 0; c < cycles_per_thread; ++c)
+                    length += cycle();
+                total_length += length;
+            });
+
+        for (auto& t : threads)
+            t.join();
+
+        const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        REQUIRE(total_length == 6 * no_of_threads * cycles_per_thread);
+
+        return static_cast<size_t>(no_of_threads * cycles_per_thread / seconds);
+    };
+
+    // use(std::move(g)) - gadget is destroyed at the end of the function
+    auto use = [](auto g) {
+        escaped_address = g.get();
+        return g->name_view().size();
+    };
+
+    for (unsigned no_of_threads : {1u, 2u, 4u, 8u, 16u, 32u})
+    {
+        const size_t make_unique_rate = cycles_per_second(no_of_threads, [&] {
+            return use(std::make_unique<Gadget>(Gadget::gen_id(), "gadget"));
+        });
+
+        const size_t pooled_rate = cycles_per_second(no_of_threads, [&] {
+            return use(make_pooled<Gadget>(Gadget::gen_id(), "gadget"));
+        });
+
+        cout << no_of_threads << " thread(s) - cycles/s: make_unique = " << make_unique_rate
+             << ", ObjectPool = " << pooled_rate << "\n";
+    }
+}
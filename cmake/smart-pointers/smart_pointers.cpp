@@ -1,3 +1,6 @@
+#include "object_pool.hpp"
+#include "stream.hpp"
+#include "unique_resource.hpp"
 #include "utils.hpp"
 #include <algorithm>
 #include <iostream>
@@ -101,6 +104,18 @@ namespace ModernCpp
     {
         std::cout << "Using " << g.name() << "\n";
     }
+
+    // memory of gadget is recycled - deleter returns it to ObjectPool<Gadget>
+    PooledPtr<Gadget> get_pooled_gadget(const std::string& name)
+    {
+        return make_pooled<Gadget>(Gadget::gen_id(), name);
+    }
+
+    void use(PooledPtr<Gadget> g)
+    {
+        if (g)
+            std::cout << "Using " << g->name() << "\n";
+    }
 }
 
 TEST_CASE("Modern C++")
@@ -137,6 +152,22 @@ TEST_CASE("Modern C++")
     }
 }
 
+TEST_CASE("Modern C++ - pooled gadgets")
+{
+    using namespace ModernCpp;
+
+    PooledPtr<Gadget> g = get_pooled_gadget("ipad");
+    const Gadget* address = g.get();
+
+    static_assert(sizeof(g) == sizeof(Gadget*));
+
+    use(std::move(g));
+    REQUIRE(g == nullptr);
+
+    PooledPtr<Gadget> recycled = get_pooled_gadget("iwatch");
+    REQUIRE(recycled.get() == address);
+}
+
 class Owner
 {
     std::string name_;
@@ -184,19 +215,28 @@ TEST_CASE("using unique_ptr to control FILE")
         fprintf(f.get(), "text");
         // may_throw()
     }
-}
 
-struct Stream
-{
-    std::string name;
+    SECTION("Modern C++ - deleter known at compile time")
+    {
+        static_assert(sizeof(std::unique_ptr<FILE, int (*)(FILE*)>) == 2 * sizeof(FILE*));
 
-    void send() { }
+        UniqueFile f {fopen("data.txt", "w+")};
+        static_assert(sizeof(f) == sizeof(FILE*));
 
-    void close()
-    {
-        std::cout << "Closing stream " << name << "\n";
+        fprintf(f.get(), "text");
+        // may_throw()
     }
-};
+
+#ifdef STREAM_HAS_FD_SINK
+    SECTION("Modern C++ - buffered Stream")
+    {
+        Stream f {"data.txt", FdSink::create("data.txt")};
+
+        f.send("text");
+        // may_throw()
+    } // flushed & closed by destructor
+#endif
+}
 
 template <typename TResource, typename TDeallocator>
 [[nodiscard]] auto make_raii(TResource* resource, TDeallocator deallocator)
@@ -214,7 +254,25 @@ TEST_CASE("Closing stream with unique_ptr")
     auto raii_closer = make_raii(&s, [](Stream* s)
         { s->close(); });
 
-    s.send();
+    s.send("data");
+}
+
+TEST_CASE("Closing stream with UniqueResource")
+{
+    Stream s1 {"dev2"};
+    Stream s2 {"dev3"};
+
+    UniqueStream closer {&s1};
+    closer->send("data");
+
+    UniqueStream moved_closer = std::move(closer); // dev2 is closed once
+    REQUIRE_FALSE(closer);
+    REQUIRE(s1.is_open());
+
+    auto raii_closer = make_raii<&Stream::close>(&s2);
+    static_assert(std::is_same<decltype(raii_closer), UniqueStream>::value);
+
+    s2.send("data");
 }
 
 namespace LegacyCode
@@ -232,32 +290,7 @@ TEST_CASE("std::unique_ptr<T[]>")
     tab[0] = 1;
 }
 
-std::string load_data(const std::string& filename)
-{
-    std::cout << "Start loading from " << filename << "\n";
-    std::this_thread::sleep_for(2s);
-    return "Content of " + filename;
-}
-
-void save_to_file(const std::string& filename)
-{
-    std::cout << "Start saving to " << filename << "\n";
-    std::this_thread::sleep_for(2s);
-    std::cout << "Saving to " << filename << " is finished\n";
-}
-
-// TEST_CASE("BUG in C++11 - async")
-// {
-//     [[maybe_unused]] int gen_id{};
-
-//     std::future<std::string> fcontent1 = std::async(std::launch::async, load_data, "input1.txt");
-//     std::future<std::string> fcontent2 = std::async(std::launch::async, load_data, "input2.txt");
-//     std::future<std::string> fcontent3 = std::async(std::launch::async, load_data, "input3.txt");
-
-//     auto f1 = std::async(std::launch::async, save_to_file, fcontent1.get());
-//     auto f2 = std::async(std::launch::async, save_to_file, fcontent2.get());
-//     auto f3 = std::async(std::launch::async, save_to_file, fcontent3.get());
-// }
+// asynchronous load & save pipeline - see async_io.hpp & async_io_tests.cpp
 
 ////////////////////////////////////////////
 // shared pointers
@@ -0,0 +1,339 @@
+#ifndef STREAM_HPP
+#define STREAM_HPP
+
+#include "unique_resource.hpp"
+#include <cerrno>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#if defined(UNIQUE_RESOURCE_HAS_POSIX_FD) && __has_include(<sys/uio.h>)
+#include <fcntl.h>
+#include <sys/uio.h>
+#define STREAM_HAS_FD_SINK
+#endif
+
+struct ConstBuffer
+{
+    const char* data;
+    size_t size;
+};
+
+////////////////////////////////////////////////////////////////////////////
+// StreamSink - destination of bytes written by Stream
+
+class StreamSink
+{
+public:
+    virtual ~StreamSink() = default;
+
+    // writes all buffers in order - throws std::system_error on failure
+    virtual void write(const ConstBuffer* buffers, size_t count) = 0;
+
+    virtual void close() noexcept
+    {
+    }
+};
+
+class MemorySink : public StreamSink
+{
+    std::string content_;
+    size_t no_of_writes_ = 0;
+
+public:
+    void write(const ConstBuffer* buffers, size_t count) override
+    {
+        for (size_t i = 0; i < count; ++i)
+            content_.append(buffers[i].data, buffers[i].size);
+
+        ++no_of_writes_;
+    }
+
+    const std::string& content() const noexcept
+    {
+        return content_;
+    }
+
+    size_t no_of_writes() const noexcept
+    {
+        return no_of_writes_;
+    }
+};
+
+#ifdef STREAM_HAS_FD_SINK
+// owns fd - every write() is one writev() call (repeated only after partial write or EINTR)
+class FdSink : public StreamSink
+{
+    UniqueFd fd_;
+
+public:
+    static constexpr size_t max_buffers = 16;
+
+    explicit FdSink(int fd)
+        : fd_ {fd}
+    {
+        if (!fd_)
+            throw std::invalid_argument("FdSink needs a valid file descriptor");
+    }
+
+    // creates or truncates file - throws std::system_error
+    static std::unique_ptr<FdSink> create(const std::string& path)
+    {
+        const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd == -1)
+            throw std::system_error(errno, std::generic_category(), "cannot open " + path);
+
+        return std::make_unique<FdSink>(fd);
+    }
+
+    void write(const ConstBuffer* buffers, size_t count) override
+    {
+        if (count > max_buffers)
+            throw std::invalid_argument("too many buffers for one write");
+
+        iovec parts[max_buffers];
+        size_t no_of_parts = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (buffers[i].size > 0)
+                parts[no_of_parts++] = iovec {const_cast<char*>(buffers[i].data), buffers[i].size};
+        }
+
+        iovec* first = parts;
+        while (no_of_parts > 0)
+        {
+            const ssize_t written = ::writev(fd_.get(), first, static_cast<int>(no_of_parts));
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+
+                throw std::system_error(errno, std::generic_category(), "writev failed");
+            }
+
+            // skips written parts - partial write of the last one moves its start
+            size_t remaining = static_cast<size_t>(written);
+            while (no_of_parts > 0 && remaining >= first->iov_len)
+            {
+                remaining -= first->iov_len;
+                ++first;
+                --no_of_parts;
+            }
+
+            if (no_of_parts > 0)
+            {
+                first->iov_base = static_cast<char*>(first->iov_base) + remaining;
+                first->iov_len -= remaining;
+            }
+        }
+    }
+
+    void close() noexcept override
+    {
+        fd_.reset();
+    }
+
+    int fd() const noexcept
+    {
+        return fd_.get();
+    }
+};
+#endif
+
+////////////////////////////////////////////////////////////////////////////
+// Stream - buffered writer
+//
+// Records are copied to the fixed buffer allocated in constructor. Record that does not fit
+// is written together with the buffer in one vectored write - it is never split or copied.
+//
+// flush() reports errors by exception. close() flushes & closes the sink, it is called by destructor
+// & by make_raii<&Stream::close>() - errors at close cannot be reported there, check failed()
+// or call flush() before.
+
+class Stream
+{
+    std::string name_;
+    std::unique_ptr<StreamSink> sink_;
+    std::unique_ptr<char[]> buffer_;
+    size_t capacity_;
+    size_t size_ = 0;
+    bool failed_ = false;
+
+    void write_through(const char* data, size_t size)
+    {
+        if (!sink_)
+            throw std::logic_error("stream " + name_ + " is closed");
+
+        const ConstBuffer parts[] = {{buffer_.get(), size_}, {data, size}};
+
+        try
+        {
+            sink_->write(parts, 2);
+        }
+        catch (...)
+        {
+            failed_ = true;
+            throw;
+        }
+
+        size_ = 0;
+    }
+
+public:
+    static constexpr size_t default_buffer_size = 64 * 1024;
+
+    // in-memory stream
+    explicit Stream(std::string name)
+        : Stream {std::move(name), std::make_unique<MemorySink>()}
+    {
+    }
+
+    Stream(std::string name, std::unique_ptr<StreamSink> sink, size_t buffer_size = default_buffer_size)
+        : name_ {std::move(name)}
+        , sink_ {std::move(sink)}
+        , buffer_ {new char[buffer_size]}
+        , capacity_ {buffer_size}
+    {
+        if (!sink_ || buffer_size == 0)
+            throw std::invalid_argument("Stream needs a sink & a buffer");
+    }
+
+    Stream(const Stream&) = delete;
+    Stream& operator=(const Stream&) = delete;
+
+    Stream(Stream&& other) noexcept
+        : name_ {std::move(other.name_)}
+        , sink_ {std::move(other.sink_)}
+        , buffer_ {std::move(other.buffer_)}
+        , capacity_ {std::exchange(other.capacity_, 0)}
+        , size_ {std::exchange(other.size_, 0)}
+        , failed_ {other.failed_}
+    {
+    }
+
+    Stream& operator=(Stream&& other) noexcept
+    {
+        if (this != &other)
+        {
+            close();
+            name_ = std::move(other.name_);
+            sink_ = std::move(other.sink_);
+            buffer_ = std::move(other.buffer_);
+            capacity_ = std::exchange(other.capacity_, 0);
+            size_ = std::exchange(other.size_, 0);
+            failed_ = other.failed_;
+        }
+
+        return *this;
+    }
+
+    ~Stream()
+    {
+        close();
+    }
+
+    const std::string& name() const noexcept
+    {
+        return name_;
+    }
+
+    Stream& send(const char* data, size_t size)
+    {
+        if (size <= capacity_ - size_)
+        {
+            std::memcpy(buffer_.get() + size_, data, size);
+            size_ += size;
+        }
+        else
+            write_through(data, size);
+
+        return *this;
+    }
+
+    Stream& send(std::string_view text)
+    {
+        return send(text.data(), text.size());
+    }
+
+    // decimal representation is formatted directly in the buffer
+    Stream& send(int64_t value)
+    {
+        constexpr size_t max_length = 20;
+
+        if (capacity_ - size_ < max_length && sink_)
+            flush();
+
+        if (capacity_ - size_ >= max_length)
+        {
+            auto [end, ec] = std::to_chars(buffer_.get() + size_, buffer_.get() + capacity_, value);
+            size_ = static_cast<size_t>(end - buffer_.get());
+            return *this;
+        }
+
+        // buffer shorter than a number
+        char digits[max_length];
+        auto [end, ec] = std::to_chars(digits, digits + max_length, value);
+        return send(digits, static_cast<size_t>(end - digits));
+    }
+
+    // bytes waiting in the buffer
+    size_t pending() const noexcept
+    {
+        return size_;
+    }
+
+    void flush()
+    {
+        if (size_ > 0)
+            write_through(nullptr, 0);
+    }
+
+    void close() noexcept
+    {
+        if (!sink_)
+            return;
+
+        try
+        {
+            flush();
+        }
+        catch (...)
+        {
+            failed_ = true;
+        }
+
+        sink_->close();
+        sink_.reset();
+        size_ = 0;
+        capacity_ = 0; // next send() throws std::logic_error
+    }
+
+    bool is_open() const noexcept
+    {
+        return sink_ != nullptr;
+    }
+
+    // write or flush has failed - data may be lost
+    bool failed() const noexcept
+    {
+        return failed_;
+    }
+
+    StreamSink* sink() const noexcept
+    {
+        return sink_.get();
+    }
+};
+
+// Stream::close() is called directly - no deleter is stored
+using UniqueStream = UniqueResource<Stream*, &Stream::close>;
+
+static_assert(sizeof(UniqueStream) == sizeof(Stream*), "UniqueStream must be pointer-sized");
+
+#endif // STREAM_HPP
@@ -0,0 +1,269 @@
+#include "stream.hpp"
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+
+#include "catch.hpp"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace
+{
+    // keeps written bytes outside of the stream - they are available after close()
+    class RecordingSink : public StreamSink
+    {
+        std::string& content_;
+        size_t& no_of_writes_;
+        bool fail_ = false;
+
+    public:
+        RecordingSink(std::string& content, size_t& no_of_writes)
+            : content_ {content}
+            , no_of_writes_ {no_of_writes}
+        {
+        }
+
+        void write(const ConstBuffer* buffers, size_t count) override
+        {
+            if (fail_)
+                throw std::system_error(std::make_error_code(std::errc::no_space_on_device), "write failed");
+
+            for (size_t i = 0; i < count; ++i)
+                content_.append(buffers[i].data, buffers[i].size);
+
+            ++no_of_writes_;
+        }
+
+        void fail()
+        {
+            fail_ = true;
+        }
+    };
+
+    class TempFile
+    {
+        fs::path path_;
+
+    public:
+        explicit TempFile(const std::string& name)
+            : path_ {fs::temp_directory_path() / ("stream_tests_" + name + ".txt")}
+        {
+        }
+
+        TempFile(const TempFile&) = delete;
+        TempFile& operator=(const TempFile&) = delete;
+
+        ~TempFile()
+        {
+            std::error_code ec;
+            fs::remove(path_, ec);
+        }
+
+        std::string path() const
+        {
+            return path_.string();
+        }
+    };
+
+    std::string read_file(const std::string& path)
+    {
+        std::ifstream in {path, std::ios::binary};
+        return std::string {std::istreambuf_iterator<char> {in}, std::istreambuf_iterator<char> {}};
+    }
+}
+
+TEST_CASE("Stream - records are buffered")
+{
+    std::string content;
+    size_t no_of_writes = 0;
+
+    Stream s {"buffered", std::make_unique<RecordingSink>(content, no_of_writes), 16};
+
+    s.send("abc").send("def");
+
+    REQUIRE(s.pending() == 6);
+    REQUIRE(no_of_writes == 0);
+
+    SECTION("flush")
+    {
+        s.flush();
+
+        REQUIRE(content == "abcdef");
+        REQUIRE(no_of_writes == 1);
+        REQUIRE(s.pending() == 0);
+    }
+
+    SECTION("record that does not fit is written with the buffer in one write")
+    {
+        s.send("0123456789abcdef");
+
+        REQUIRE(content == "abcdef0123456789abcdef");
+        REQUIRE(no_of_writes == 1);
+        REQUIRE(s.pending() == 0);
+    }
+
+    SECTION("close flushes")
+    {
+        s.close();
+
+        REQUIRE(content == "abcdef");
+        REQUIRE_FALSE(s.is_open());
+        REQUIRE_THROWS_AS(s.send("x"), std::logic_error);
+    }
+}
+
+TEST_CASE("Stream - numbers")
+{
+    std::string content;
+    size_t no_of_writes = 0;
+
+    SECTION("are formatted in the buffer")
+    {
+        Stream s {"numbers", std::make_unique<RecordingSink>(content, no_of_writes)};
+
+        s.send(0).send(" ").send(-42).send(" ").send(std::numeric_limits<int64_t>::min());
+        s.flush();
+
+        REQUIRE(content == "0 -42 -9223372036854775808");
+    }
+
+    SECTION("buffer shorter than a number")
+    {
+        Stream s {"numbers", std::make_unique<RecordingSink>(content, no_of_writes), 4};
+
+        s.send("n=").send(1234567).send(";");
+        s.flush();
+
+        REQUIRE(content == "n=1234567;");
+    }
+}
+
+TEST_CASE("Stream - errors")
+{
+    std::string content;
+    size_t no_of_writes = 0;
+
+    auto sink = std::make_unique<RecordingSink>(content, no_of_writes);
+    RecordingSink& failing_sink = *sink;
+
+    Stream s {"errors", std::move(sink)};
+    s.send("lost");
+    failing_sink.fail();
+
+    SECTION("are reported by flush")
+    {
+        REQUIRE_THROWS_AS(s.flush(), std::system_error);
+        REQUIRE(s.failed());
+    }
+
+    SECTION("are not thrown by close")
+    {
+        s.close();
+
+        REQUIRE(s.failed());
+        REQUIRE_FALSE(s.is_open());
+    }
+}
+
+TEST_CASE("Stream - closed with make_raii")
+{
+    std::string content;
+    size_t no_of_writes = 0;
+
+    Stream s {"raii", std::make_unique<RecordingSink>(content, no_of_writes)};
+
+    {
+        auto closer = make_raii<&Stream::close>(&s);
+        s.send("record");
+    }
+
+    REQUIRE(content == "record");
+    REQUIRE_FALSE(s.is_open());
+}
+
+#ifdef STREAM_HAS_FD_SINK
+TEST_CASE("Stream - FdSink")
+{
+    TempFile file {"fd_sink"};
+    std::string expected;
+
+    {
+        Stream s {"file", FdSink::create(file.path()), 1024};
+
+        for (int i = 0; i < 10'000; ++i)
+        {
+            s.send("record ").send(i).send("\n");
+            expected += "record " + std::to_string(i) + "\n";
+        }
+
+        s.send(std::string(5000, 'x'));
+        expected += std::string(5000, 'x');
+    }
+
+    REQUIRE(read_file(file.path()) == expected);
+}
+
+TEST_CASE("Stream - small records", "[.][benchmark]")
+{
+    const int no_of_records = 2'000'000;
+
+    auto report = [](const char* description, chrono::steady_clock::time_point start) {
+        const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << description << ": " << static_cast<size_t>(no_of_records / seconds) << " records/s\n";
+    };
+
+    {
+        TempFile file {"fprintf"};
+        const auto start = chrono::steady_clock::now();
+
+        UniqueFile f {std::fopen(file.path().c_str(), "w")};
+        for (int i = 0; i < no_of_records; ++i)
+            std::fprintf(f.get(), "record %d: %d\n", i, i * 7);
+        f.reset();
+
+        report("fprintf", start);
+    }
+
+    {
+        TempFile file {"ofstream"};
+        const auto start = chrono::steady_clock::now();
+
+        {
+            std::ofstream out {file.path()};
+            for (int i = 0; i < no_of_records; ++i)
+                out << "record " << i << ": " << i * 7 << '\n';
+        }
+
+        report("std::ofstream", start);
+    }
+
+    {
+        TempFile file {"stream"};
+        const auto start = chrono::steady_clock::now();
+
+        {
+            Stream s {"file", FdSink::create(file.path())};
+            for (int i = 0; i < no_of_records; ++i)
+                s.send("record ").send(i).send(": ").send(i * 7).send("\n");
+        }
+
+        report("Stream - FdSink", start);
+    }
+
+    {
+        const auto start = chrono::steady_clock::now();
+
+        Stream s {"memory"};
+        for (int i = 0; i < no_of_records; ++i)
+            s.send("record ").send(i).send(": ").send(i * 7).send("\n");
+        s.close();
+
+        report("Stream - MemorySink", start);
+    }
+}
+#endif
@@ -0,0 +1,115 @@
+#ifndef UNIQUE_RESOURCE_HPP
+#define UNIQUE_RESOURCE_HPP
+
+#include <cstdio>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+#if __has_include(<unistd.h>)
+#include <unistd.h>
+#define UNIQUE_RESOURCE_HAS_POSIX_FD
+#endif
+
+////////////////////////////////////////////////////////////////////////////
+// UniqueResource<TResource, Deleter, Invalid> - exclusive owner of a handle
+//
+// Deleter is a compile-time constant (function or member function pointer) - it is not stored
+// in the object & it is called directly: UniqueResource has the size of TResource.
+// Handle equal to Invalid (nullptr for pointers, -1 for POSIX fds) is not released.
+
+template <typename TResource, auto Deleter, TResource Invalid = TResource {}>
+class UniqueResource
+{
+    static_assert(std::is_trivially_copyable<TResource>::value, "handle must be trivially copyable");
+    static_assert(std::is_invocable<decltype(Deleter), TResource>::value, "Deleter must be callable with the handle");
+
+    TResource resource_ = Invalid;
+
+public:
+    static constexpr TResource invalid = Invalid;
+
+    UniqueResource() noexcept = default;
+
+    explicit UniqueResource(TResource resource) noexcept
+        : resource_ {resource}
+    {
+    }
+
+    UniqueResource(const UniqueResource&) = delete;
+    UniqueResource& operator=(const UniqueResource&) = delete;
+
+    UniqueResource(UniqueResource&& other) noexcept
+        : resource_ {other.release()}
+    {
+    }
+
+    UniqueResource& operator=(UniqueResource&& other) noexcept
+    {
+        if (this != &other)
+            reset(other.release());
+
+        return *this;
+    }
+
+    ~UniqueResource()
+    {
+        reset();
+    }
+
+    TResource get() const noexcept
+    {
+        return resource_;
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return resource_ != Invalid;
+    }
+
+    // for pointer handles only
+    TResource operator->() const noexcept
+    {
+        return resource_;
+    }
+
+    // ownership is passed to the caller - handle is not released
+    [[nodiscard]] TResource release() noexcept
+    {
+        return std::exchange(resource_, Invalid);
+    }
+
+    void reset(TResource resource = Invalid) noexcept
+    {
+        TResource old = std::exchange(resource_, resource);
+        if (old != Invalid)
+            std::invoke(Deleter, old);
+    }
+
+    void swap(UniqueResource& other) noexcept
+    {
+        std::swap(resource_, other.resource_);
+    }
+};
+
+// make_raii v2 - deleter is a template argument: auto f = make_raii<&std::fclose>(std::fopen(...));
+template <auto Deleter, typename TResource>
+[[nodiscard]] auto make_raii(TResource resource) noexcept
+{
+    return UniqueResource<TResource, Deleter> {resource};
+}
+
+////////////////////////////////////////////////////////////////////////////
+// adapters
+
+using UniqueFile = UniqueResource<std::FILE*, &std::fclose>;
+
+static_assert(sizeof(UniqueFile) == sizeof(std::FILE*), "UniqueFile must be pointer-sized");
+
+#ifdef UNIQUE_RESOURCE_HAS_POSIX_FD
+using UniqueFd = UniqueResource<int, &::close, -1>;
+
+static_assert(sizeof(UniqueFd) == sizeof(int), "UniqueFd must have size of fd");
+#endif
+
+#endif // UNIQUE_RESOURCE_HPP
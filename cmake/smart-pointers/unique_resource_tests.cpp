@@ -0,0 +1,120 @@
+#include "unique_resource.hpp"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+
+using namespace std;
+
+namespace
+{
+    vector<int> released_handles;
+
+    void release_handle(int handle) noexcept
+    {
+        released_handles.push_back(handle);
+    }
+
+    using Handle = UniqueResource<int, &release_handle, -1>;
+
+    static_assert(sizeof(Handle) == sizeof(int));
+}
+
+TEST_CASE("UniqueResource")
+{
+    released_handles.clear();
+
+    SECTION("handle is released in destructor")
+    {
+        {
+            Handle h {7};
+            REQUIRE(h);
+            REQUIRE(h.get() == 7);
+        }
+
+        REQUIRE(released_handles == vector<int> {7});
+    }
+
+    SECTION("invalid handle is not released")
+    {
+        {
+            Handle empty;
+            Handle invalid {-1};
+
+            REQUIRE_FALSE(empty);
+            REQUIRE(empty.get() == Handle::invalid);
+        }
+
+        REQUIRE(released_handles.empty());
+    }
+
+    SECTION("move passes ownership")
+    {
+        {
+            Handle h1 {1};
+            Handle h2 {2};
+
+            h2 = std::move(h1);
+
+            REQUIRE(released_handles == vector<int> {2});
+            REQUIRE_FALSE(h1);
+            REQUIRE(h2.get() == 1);
+
+            Handle h3 = std::move(h2);
+            REQUIRE(h3.get() == 1);
+        }
+
+        REQUIRE(released_handles == (vector<int> {2, 1}));
+    }
+
+    SECTION("release & reset")
+    {
+        Handle h {3};
+
+        const int raw = h.release();
+        REQUIRE(raw == 3);
+        REQUIRE_FALSE(h);
+
+        h.reset(4);
+        h.reset(5);
+        h.reset();
+
+        REQUIRE(released_handles == (vector<int> {4, 5}));
+    }
+}
+
+TEST_CASE("UniqueFile")
+{
+    UniqueFile f {std::tmpfile()};
+    REQUIRE(f);
+
+    std::fputs("text", f.get());
+
+    f.reset();
+    REQUIRE(f.get() == nullptr);
+
+    auto raii_file = make_raii<&std::fclose>(std::tmpfile());
+    static_assert(std::is_same<decltype(raii_file), UniqueFile>::value);
+}
+
+#ifdef UNIQUE_RESOURCE_HAS_POSIX_FD
+TEST_CASE("UniqueFd")
+{
+    int fds[2];
+    REQUIRE(::pipe(fds) == 0);
+
+    UniqueFd read_end {fds[0]};
+    UniqueFd write_end {fds[1]};
+
+    REQUIRE(::write(write_end.get(), "x", 1) == 1);
+    write_end.reset();
+
+    char buffer[2];
+    REQUIRE(::read(read_end.get(), buffer, sizeof(buffer)) == 1);
+    REQUIRE(::read(read_end.get(), buffer, sizeof(buffer)) == 0); // write end is closed
+
+    UniqueFd failed {::dup(-1)};
+    REQUIRE_FALSE(failed);
+}
+#endif
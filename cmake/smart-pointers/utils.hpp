@@ -1,9 +1,13 @@
+#include <atomic>
 #include <iostream>
 #include <string>
 #include <string_view>
+#include <utility>
 
 #define ENABLE_MOVE_SEMANTICS
 
+// define GADGET_PRODUCTION_MODE to compile out logging of special members of Gadget
+
 namespace Utils
 {
     template <typename Container>
@@ -20,37 +24,66 @@ namespace Utils
         int id_;
         std::string name_;
 
+        // arguments are evaluated also when logging is compiled out - they must not allocate
+        template <typename... TArgs>
+        static void log(const TArgs&... args)
+        {
+            if constexpr (logging_enabled)
+            {
+                (std::cout << ... << args) << std::endl;
+            }
+        }
+
     public:
+#ifdef GADGET_PRODUCTION_MODE
+        static constexpr bool logging_enabled = false;
+#else
+        static constexpr bool logging_enabled = true;
+#endif
+
+        static constexpr int id_block_size = 1024;
+
+        // thread-safe - every thread reserves a block of ids with one atomic increment
+        // ids generated by one thread are increasing, ids from different threads are not ordered
         static int gen_id()
         {
-            static int id_seed;
-            return ++id_seed;
+            static std::atomic<int> id_seed {0};
+            thread_local int next_id = 0;
+            thread_local int block_end = 0;
+
+            if (next_id == block_end)
+            {
+                next_id = id_seed.fetch_add(id_block_size, std::memory_order_relaxed) + 1;
+                block_end = next_id + id_block_size;
+            }
+
+            return next_id++;
         }
 
         Gadget()
             : id_ {gen_id()}
             , name_ {"not-set"}
         {
-            std::cout << "Gadget(" << id_ << ", " << name_ << ")" << std::endl;
+            log("Gadget(", id_, ", ", name_, ")");
         }
 
-        Gadget(int id, const std::string& name = "unknown")
+        Gadget(int id, std::string name = "unknown")
             : id_ {id}
-            , name_ {name}
+            , name_ {std::move(name)}
         {
-            std::cout << "Gadget(" << id_ << ", " << name_ << ")" << std::endl;
+            log("Gadget(", id_, ", ", name_, ")");
         }
 
         ~Gadget()
         {
-            std::cout << "~Gadget(" << (name_.empty() ? "after-move" : name_) << ", " << id_ << ")" << std::endl;
+            log("~Gadget(", (name_.empty() ? std::string_view {"after-move"} : std::string_view {name_}), ", ", id_, ")");
         }
 
         Gadget(const Gadget& source)
             : id_ {source.id_}
             , name_ {source.name_}
         {
-            std::cout << "Gadget(cc: " << id_ << ", " << name_ << ")" << std::endl;
+            log("Gadget(cc: ", id_, ", ", name_, ")");
         }
 
         Gadget& operator=(const Gadget& source)
@@ -60,7 +93,7 @@ namespace Utils
                 id_ = source.id_;
                 name_ = source.name_;
 
-                std::cout << "Gadget::operator=(cpy: " << id_ << ", " << name_ << ")" << std::endl;
+                log("Gadget::operator=(cpy: ", id_, ", ", name_, ")");
             }
 
             return *this;
@@ -74,25 +107,25 @@ namespace Utils
         {
             if (this != &source)
             {
-                std::cout << "Gadget(mv: " << id_ << ", " << name_ << ")" << std::endl;
+                log("Gadget(mv: ", id_, ", ", name_, ")");
             }
         }
 
-        Gadget& operator=(Gadget&& source)
+        Gadget& operator=(Gadget&& source) noexcept
         {
             if (this != &source)
             {
                 id_ = source.id_;
                 name_ = std::move(source.name_);
 
-                std::cout << "Gadget::operator=(mv: " << id_ << ", " << name_ << ")" << std::endl;
+                log("Gadget::operator=(mv: ", id_, ", ", name_, ")");
             }
 
             return *this;
         }
 #endif
 
-        int id() const
+        int id() const noexcept
         {
             return id_;
         }
@@ -101,11 +134,17 @@ namespace Utils
         {
             return name_;
         }
+
+        // no allocation - view is valid until the gadget is destroyed or assigned
+        std::string_view name_view() const noexcept
+        {
+            return name_;
+        }
     };
 
     inline std::ostream& operator<<(std::ostream& out, const Gadget& g)
     {
-        out << "Gadget{id: " << g.id() << ", name: " << g.name() << "}";
+        out << "Gadget{id: " << g.id() << ", name: " << g.name_view() << "}";
         return out;
     }
 }
\ No newline at end of file